@@ -91,7 +91,7 @@ public func topologicalSort<Node: Comparable>(_ graph: [Node: Set<Node>], nodes:
 
 /// Returns the set of nodes that the given node in the provided graph has as
 /// its incoming nodes, both directly and transitively.
-private func transitiveIncomingNodes<Node>(_ graph: [Node: Set<Node>], node: Node) -> Set<Node> {
+internal func transitiveIncomingNodes<Node>(_ graph: [Node: Set<Node>], node: Node) -> Set<Node> {
 	guard let nodes = graph[node] else {
 		return Set()
 	}
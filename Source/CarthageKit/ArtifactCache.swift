@@ -0,0 +1,279 @@
+import Foundation
+import Result
+import ReactiveSwift
+import XCDBLD
+
+/// Identifies the build products of a dependency in an artifact cache.
+///
+/// Products are only interchangeable between builds that agree on every
+/// component of the key.
+public struct ArtifactCacheKey: Hashable {
+	/// The name of the dependency.
+	public let dependencyName: String
+
+	/// The revision of the dependency that was built.
+	public let commitish: String
+
+	/// The version of the Swift compiler the dependency was built with.
+	public let swiftToolchainVersion: String
+
+	/// The platforms the dependency was built for, or nil for all of them.
+	public let platforms: Set<SDK>?
+
+	/// The Xcode configuration the dependency was built with.
+	public let configuration: String
+
+	/// Whether the products were packaged as XCFrameworks.
+	public let useXCFrameworks: Bool
+
+	public init(
+		dependencyName: String,
+		commitish: String,
+		swiftToolchainVersion: String,
+		platforms: Set<SDK>?,
+		configuration: String,
+		useXCFrameworks: Bool
+	) {
+		self.dependencyName = dependencyName
+		self.commitish = commitish
+		self.swiftToolchainVersion = swiftToolchainVersion
+		self.platforms = platforms
+		self.configuration = configuration
+		self.useXCFrameworks = useXCFrameworks
+	}
+
+	/// The location of the artifact relative to the root of the cache.
+	///
+	/// ReactiveSwift/6.1.0/7d1a5e….zip
+	public var relativePath: String {
+		var allowedCharacters = CharacterSet.alphanumerics
+		allowedCharacters.insert(charactersIn: "-_.+")
+		let escapedCommitish = commitish.addingPercentEncoding(withAllowedCharacters: allowedCharacters) ?? commitish
+
+		let platformNames = platforms.map { $0.map { $0.rawValue }.sorted().joined(separator: ",") } ?? "all"
+		let variant = [
+			swiftToolchainVersion,
+			configuration,
+			platformNames,
+			useXCFrameworks ? "xcframework" : "framework",
+		].joined(separator: "\n")
+
+		return "\(dependencyName)/\(escapedCommitish)/\(sha256HexDigest(of: variant)).zip"
+	}
+}
+
+extension ArtifactCacheKey {
+	/// Creates the key for building the given dependency with the given options
+	/// and the selected Swift toolchain.
+	internal static func make(for dependency: Dependency, version: PinnedVersion, options: BuildOptions) -> SignalProducer<ArtifactCacheKey, CarthageError> {
+		return swiftVersion(usingToolchain: options.toolchain)
+			.mapError { error in CarthageError.internalError(description: error.description) }
+			.map { swiftVersion in
+				ArtifactCacheKey(
+					dependencyName: dependency.name,
+					commitish: version.commitish,
+					swiftToolchainVersion: swiftVersion,
+					platforms: options.platforms,
+					configuration: options.configuration,
+					useXCFrameworks: options.useXCFrameworks
+				)
+			}
+	}
+}
+
+/// A store of zipped build products shared between machines, so that a
+/// dependency built on one of them doesn't have to be rebuilt on the others.
+///
+/// Artifacts use the layout of `carthage archive`, so that they can be
+/// installed like binaries downloaded from a release.
+public protocol ArtifactCache {
+	/// Sends the file URL of a local copy of the artifact for the given key, or
+	/// nil if the cache doesn't have it. The caller owns the local copy.
+	func fetch(_ key: ArtifactCacheKey) -> SignalProducer<URL?, CarthageError>
+
+	/// Stores the zip at the given file URL as the artifact for the given key.
+	func store(_ archiveURL: URL, for key: ArtifactCacheKey) -> SignalProducer<(), CarthageError>
+}
+
+/// An artifact cache served over HTTP.
+///
+/// Artifacts are fetched with `GET <base URL>/<relative path>`, where a 404
+/// response means the artifact is not cached, and stored with `PUT` on the
+/// same URL.
+internal final class HTTPArtifactCache: ArtifactCache {
+	let baseURL: URL
+	private let transport: Transport
+
+	init(baseURL: URL, transport: Transport) {
+		self.baseURL = baseURL
+		self.transport = transport
+	}
+
+	func fetch(_ key: ArtifactCacheKey) -> SignalProducer<URL?, CarthageError> {
+		let url = baseURL.appendingPathComponent(key.relativePath)
+
+		return transport.download(with: URLRequest(url: url))
+			.mapError { CarthageError.readFailed(url, $0 as NSError) }
+			.attemptMap { downloadURL, response -> Result<URL?, CarthageError> in
+				guard let response = response as? HTTPURLResponse else {
+					return .success(nil)
+				}
+
+				switch response.statusCode {
+				case 200...299:
+					// The downloaded file is removed once the download task
+					// finishes, so move it out of the way right away.
+					let temporaryURL = FileManager.default.temporaryDirectory
+						.appendingPathComponent("carthage-artifact-\(UUID().uuidString).zip", isDirectory: false)
+					return Result(at: temporaryURL, attempt: { url -> URL? in
+						try FileManager.default.moveItem(at: downloadURL, to: url)
+						return url
+					})
+
+				case 404:
+					return .success(nil)
+
+				default:
+					let description = HTTPURLResponse.localizedString(forStatusCode: response.statusCode)
+					return .failure(.internalError(description: "Fetching \(url) failed with status \(response.statusCode): \(description)"))
+				}
+			}
+	}
+
+	func store(_ archiveURL: URL, for key: ArtifactCacheKey) -> SignalProducer<(), CarthageError> {
+		let url = baseURL.appendingPathComponent(key.relativePath)
+
+		var request = URLRequest(url: url)
+		request.httpMethod = "PUT"
+		request.setValue("application/zip", forHTTPHeaderField: "Content-Type")
+
+		return transport.upload(with: request, fromFile: archiveURL)
+			.mapError { CarthageError.writeFailed(url, $0 as NSError) }
+			.attemptMap { _, response -> Result<(), CarthageError> in
+				guard let response = response as? HTTPURLResponse else {
+					return .success(())
+				}
+				if (200...299).contains(response.statusCode) {
+					return .success(())
+				}
+
+				let description = HTTPURLResponse.localizedString(forStatusCode: response.statusCode)
+				return .failure(.internalError(description: "Storing \(url) failed with status \(response.statusCode): \(description)"))
+			}
+	}
+}
+
+/// An artifact cache kept in a local or network-mounted directory, laid out
+/// the same way as the HTTP cache.
+internal final class DirectoryArtifactCache: ArtifactCache {
+	let directoryURL: URL
+
+	init(directoryURL: URL) {
+		precondition(directoryURL.isFileURL)
+		self.directoryURL = directoryURL
+	}
+
+	func fetch(_ key: ArtifactCacheKey) -> SignalProducer<URL?, CarthageError> {
+		let artifactURL = directoryURL.appendingPathComponent(key.relativePath)
+		guard FileManager.default.fileExists(atPath: artifactURL.path) else {
+			return SignalProducer(value: nil)
+		}
+
+		let temporaryURL = FileManager.default.temporaryDirectory
+			.appendingPathComponent("carthage-artifact-\(UUID().uuidString).zip", isDirectory: false)
+		let result = Result(at: temporaryURL, carthageError: { CarthageError.readFailed(artifactURL, $1) }, attempt: { url -> URL? in
+			try FileManager.default.copyItem(at: artifactURL, to: url)
+			return url
+		})
+		return SignalProducer(result: result)
+	}
+
+	func store(_ archiveURL: URL, for key: ArtifactCacheKey) -> SignalProducer<(), CarthageError> {
+		let artifactURL = directoryURL.appendingPathComponent(key.relativePath)
+
+		return SignalProducer(result: Result(at: artifactURL, attempt: { destinationURL in
+			let fileManager = FileManager.default
+			try fileManager.createDirectory(at: destinationURL.deletingLastPathComponent(), withIntermediateDirectories: true)
+
+			// Copy next to the destination first, so that concurrent readers
+			// never see a partially written artifact.
+			let stagingURL = destinationURL.deletingLastPathComponent()
+				.appendingPathComponent(".\(UUID().uuidString).zip", isDirectory: false)
+			try fileManager.copyItem(at: archiveURL, to: stagingURL)
+
+			let result = stagingURL.withUnsafeFileSystemRepresentation { old in
+				destinationURL.withUnsafeFileSystemRepresentation { new in
+					rename(old!, new!)
+				}
+			}
+			if result != 0 {
+				let error = NSError(domain: NSPOSIXErrorDomain, code: Int(errno), userInfo: nil)
+				try? fileManager.removeItem(at: stagingURL)
+				throw error
+			}
+		}))
+	}
+}
+
+/// Creates the artifact cache at the given location: an HTTP cache for
+/// `http(s)://` URLs, or a directory cache for `file://` URLs and paths.
+///
+/// Fails for URLs with any other scheme.
+internal func artifactCache(at location: String, transport: Transport) -> Result<ArtifactCache, CarthageError> {
+	guard let url = URL(string: location), let scheme = url.scheme else {
+		return .success(DirectoryArtifactCache(directoryURL: URL(fileURLWithPath: location, isDirectory: true)))
+	}
+
+	switch scheme.lowercased() {
+	case "http", "https":
+		return .success(HTTPArtifactCache(baseURL: url, transport: transport))
+
+	case "file":
+		return .success(DirectoryArtifactCache(directoryURL: url))
+
+	default:
+		return .failure(.invalidArgument(description: "Unsupported scheme \"\(scheme)\" in artifact cache location \(location); expected http, https or file"))
+	}
+}
+
+/// Sends the paths, relative to the given root directory, of the built
+/// frameworks recorded in the version file of the given dependency, along with
+/// their dSYMs and bcsymbolmaps.
+internal func artifactPaths(for dependency: Dependency, rootDirectoryURL: URL) -> SignalProducer<[String], CarthageError> {
+	guard let versionFile = VersionFile(url: VersionFile.url(for: dependency, rootDirectoryURL: rootDirectoryURL)) else {
+		return SignalProducer(value: [])
+	}
+
+	let binariesDirectoryURL = rootDirectoryURL.appendingPathComponent(Constants.binariesFolderPath, isDirectory: true)
+	let platforms = SDK.knownIn2019YearSDKs.filter { $0.isDevice }
+	let rootPath = rootDirectoryURL.path + "/"
+	let relativePath: (URL) -> String = { $0.path.stripping(prefix: rootPath) }
+
+	return SignalProducer<SDK, CarthageError>(platforms)
+		.flatMap(.concat) { platform -> SignalProducer<String, CarthageError> in
+			return SignalProducer<CachedFramework, CarthageError>(versionFile[platform] ?? [])
+				.flatMap(.concat) { cachedFramework -> SignalProducer<String, CarthageError> in
+					if let container = cachedFramework.container {
+						// XCFrameworks carry their own debug information.
+						return SignalProducer(value: relativePath(binariesDirectoryURL.appendingPathComponent(container, isDirectory: true)))
+					}
+
+					let frameworkURL = cachedFramework.location(in: binariesDirectoryURL, sdk: platform)
+					guard FileManager.default.fileExists(atPath: frameworkURL.path) else {
+						return .empty
+					}
+
+					let dSYMURL = frameworkURL.appendingPathExtension("dSYM")
+					let dSYM: SignalProducer<URL, CarthageError> = FileManager.default.fileExists(atPath: dSYMURL.path)
+						? SignalProducer(value: dSYMURL)
+						: .empty
+
+					return SignalProducer(value: frameworkURL)
+						.concat(dSYM)
+						.concat(BCSymbolMapsForFramework(frameworkURL))
+						.map(relativePath)
+				}
+		}
+		.collect()
+		.map { paths in Array(Set(paths)).sorted() }
+}
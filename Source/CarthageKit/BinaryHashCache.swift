@@ -0,0 +1,116 @@
+import Darwin
+import Foundation
+import Result
+
+/// Persists the SHA-256 digests of framework binaries and of the files in the
+/// binaries cache between runs, so that checking whether cached builds and
+/// downloads are still valid doesn't have to read files which haven't
+/// changed.
+///
+/// Each binary has one entry, keyed by its path, which records its digest
+/// along with the device, inode, size, and modification and status change
+/// times (in nanoseconds) of the file it was computed from. Replacing or
+/// writing to a file changes at least one of those, so its digest is computed
+/// again, and the entry is overwritten.
+internal struct BinaryHashCache {
+	/// Bumped whenever the format of keys or entries changes.
+	private static let formatVersion = 2
+
+	/// The contents of an entry.
+	struct Entry: Codable {
+		let attributes: String
+		let sha256: String
+	}
+
+	/// Sends the hexadecimal SHA-256 digest of the file at the given URL,
+	/// only reading the file if its digest hasn't been recorded since it last
+	/// changed, or if `rehash` is true.
+	///
+	/// The digest is recorded either way.
+	static func hash(
+		ofFileAt fileURL: URL,
+		rehash: Bool = false,
+		directoryURL: URL = Constants.Dependency.binaryHashesURL
+	) -> Result<String, CarthageError> {
+		guard let attributes = attributes(ofFileAt: fileURL) else {
+			return sha256Digest(ofFileAt: fileURL)
+		}
+
+		if !rehash, let entry = entry(forFileAt: fileURL, directoryURL: directoryURL), entry.attributes == attributes {
+			return .success(entry.sha256)
+		}
+
+		return sha256Digest(ofFileAt: fileURL).map { digest in
+			record(digest, forFileAt: fileURL, attributes: attributes, directoryURL: directoryURL)
+			return digest
+		}
+	}
+
+	/// Reads the entry for the file at the given URL, whether or not the file
+	/// changed since.
+	static func entry(forFileAt fileURL: URL, directoryURL: URL = Constants.Dependency.binaryHashesURL) -> Entry? {
+		guard
+			let data = try? Data(contentsOf: entryURL(forFileAt: fileURL, directoryURL: directoryURL)),
+			let entry = try? JSONDecoder().decode(Entry.self, from: data),
+			entry.sha256.count == 64
+		else {
+			return nil
+		}
+
+		return entry
+	}
+
+	/// Records the given digest for the file at the given URL in its current
+	/// state, overwriting its previous entry.
+	@discardableResult
+	static func record(
+		_ digest: String,
+		forFileAt fileURL: URL,
+		attributes: String? = nil,
+		directoryURL: URL = Constants.Dependency.binaryHashesURL
+	) -> Result<(), CarthageError> {
+		guard let attributes = attributes ?? self.attributes(ofFileAt: fileURL) else {
+			return .failure(.readFailed(fileURL, nil))
+		}
+
+		return Result(at: entryURL(forFileAt: fileURL, directoryURL: directoryURL), attempt: {
+			let data = try JSONEncoder().encode(Entry(attributes: attributes, sha256: digest))
+			try FileManager.default.createDirectory(at: directoryURL, withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+
+	/// Removes the entry for the file at the given URL, if there is one.
+	static func removeEntry(forFileAt fileURL: URL, directoryURL: URL = Constants.Dependency.binaryHashesURL) {
+		_ = try? FileManager.default.removeItem(at: entryURL(forFileAt: fileURL, directoryURL: directoryURL))
+	}
+
+	/// The file URL of the entry for the file at the given URL.
+	static func entryURL(forFileAt fileURL: URL, directoryURL: URL) -> URL {
+		let key = sha256HexDigest(of: "\(formatVersion)\n\(fileURL.resolvingSymlinksInPath().path)")
+		return directoryURL.appendingPathComponent("\(key).json", isDirectory: false)
+	}
+
+	/// Describes the current state of the file at the given URL, or returns
+	/// nil if the file can't be examined.
+	static func attributes(ofFileAt fileURL: URL) -> String? {
+		var status = stat()
+		guard stat(fileURL.path, &status) == 0 else {
+			return nil
+		}
+
+		func nanoseconds(_ time: timespec) -> Int64 {
+			return Int64(time.tv_sec) * 1_000_000_000 + Int64(time.tv_nsec)
+		}
+
+		let components = [
+			"\(status.st_dev)",
+			"\(status.st_ino)",
+			"\(status.st_size)",
+			"\(nanoseconds(status.st_mtimespec))",
+			"\(nanoseconds(status.st_ctimespec))",
+		]
+
+		return components.joined(separator: " ")
+	}
+}
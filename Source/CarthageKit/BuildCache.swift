@@ -0,0 +1,303 @@
+import Foundation
+import Result
+import ReactiveSwift
+import XCDBLD
+
+/// Digests everything that determines the build products of a dependency:
+///
+/// - the Git tree of the files in the checkout as they are, local changes
+///   included, so that the same sources are recognized whichever tag or
+///   commit they were checked out at,
+/// - the project, workspace, scheme and configuration files of the checkout,
+/// - the contents of the `XCODE_XCCONFIG_FILE` the build inherits, and the
+///   build settings it inherits from the environment,
+/// - the selected Xcode and Swift toolchain and the build options,
+/// - the frameworks which have been built for each of its dependencies.
+internal struct BuildInputs {
+	/// Bumped whenever the components of the digest change.
+	private static let formatVersion = 3
+
+	/// Sends the digest of the inputs of building the given dependency after
+	/// the given dependencies of it, or nil if they can't all be determined.
+	static func digest(
+		for dependency: Dependency,
+		dependencies: Set<Dependency>,
+		repositoryURL: URL,
+		rootDirectoryURL: URL,
+		options: BuildOptions
+	) -> SignalProducer<String?, NoError> {
+		let checkoutURL = rootDirectoryURL.appendingPathComponent(dependency.relativePath, isDirectory: true)
+
+		let treeHash = workingTreeHash(ofCheckoutAt: checkoutURL, repositoryURL: repositoryURL)
+		let swiftToolchainVersion = swiftVersion(usingToolchain: options.toolchain)
+			.mapError { error in CarthageError.internalError(description: error.description) }
+
+		return SignalProducer.zip(treeHash, swiftToolchainVersion)
+			.map { treeHash, swiftToolchainVersion -> String? in
+				guard
+					let xcodeFingerprint = BuildSettingsCache.xcodeFingerprint,
+					let projectFingerprint = BuildSettingsCache.fingerprint(ofProjectFilesIn: checkoutURL),
+					let xcconfigFingerprint = BuildSettingsCache.inheritedXCConfigFingerprint()
+				else {
+					return nil
+				}
+
+				let platformNames = options.platforms.map { $0.map { $0.rawValue }.sorted().joined(separator: ",") } ?? "all"
+				let components = [
+					"\(formatVersion)",
+					treeHash,
+					projectFingerprint,
+					xcconfigFingerprint,
+					xcodeFingerprint,
+					swiftToolchainVersion,
+					options.configuration,
+					platformNames,
+					options.useXCFrameworks ? "xcframework" : "framework",
+				]
+				let dependencyProducts = dependencies
+					.sorted { $0.name < $1.name }
+					.map { builtProducts(of: $0, rootDirectoryURL: rootDirectoryURL) }
+
+				return sha256HexDigest(of: (components + dependencyProducts).joined(separator: "\n"))
+			}
+			// Without a digest, the build just isn't cached.
+			.flatMapError { _ in SignalProducer(value: nil) }
+	}
+
+	/// Sends the hash of the Git tree of the files in the given checkout as
+	/// they are now, leaving out the build products and checkouts nested in
+	/// it.
+	///
+	/// The files are staged into an index of the checkout's own, kept in the
+	/// repository cache, so that only the files which changed since the last
+	/// build are read again. The objects that staging writes go to a
+	/// directory of their own which is removed afterwards, so that local
+	/// changes never end up in the repository cache.
+	private static func workingTreeHash(ofCheckoutAt checkoutURL: URL, repositoryURL: URL) -> SignalProducer<String, CarthageError> {
+		let indexURL = repositoryURL
+			.appendingPathComponent("carthage-indexes", isDirectory: true)
+			.appendingPathComponent(sha256HexDigest(of: checkoutURL.standardizedFileURL.path), isDirectory: false)
+		let objectsURL = FileManager.default.temporaryDirectory
+			.appendingPathComponent("carthage-objects-\(UUID().uuidString)", isDirectory: true)
+		let pathspec = [ ":/", ":(top,exclude)\(Constants.binariesFolderPath)", ":(top,exclude)\(Constants.checkoutsFolderPath)" ]
+
+		return SignalProducer { () -> Result<[String: String], CarthageError> in
+				return Result(at: indexURL.deletingLastPathComponent(), attempt: {
+					try FileManager.default.createDirectory(at: $0, withIntermediateDirectories: true)
+					try FileManager.default.createDirectory(at: objectsURL, withIntermediateDirectories: true)
+				})
+				.map { _ in
+					var environment = ProcessInfo.processInfo.environment
+					environment["GIT_WORK_TREE"] = checkoutURL.path
+					environment["GIT_INDEX_FILE"] = indexURL.path
+					environment["GIT_OBJECT_DIRECTORY"] = objectsURL.path
+					environment["GIT_ALTERNATE_OBJECT_DIRECTORIES"] = repositoryURL.appendingPathComponent("objects", isDirectory: true).path
+					return environment
+				}
+			}
+			.flatMap(.concat) { environment in
+				launchGitTask([ "add", "--all", "--" ] + pathspec, repositoryFileURL: repositoryURL, environment: environment)
+					// Blobs staged by earlier builds were removed along with
+					// their object directories.
+					.then(launchGitTask([ "write-tree", "--missing-ok" ], repositoryFileURL: repositoryURL, environment: environment))
+			}
+			.map { $0.trimmingCharacters(in: .whitespacesAndNewlines) }
+			.on(terminated: {
+				_ = try? FileManager.default.removeItem(at: objectsURL)
+			})
+	}
+
+	/// Describes the frameworks recorded in the version file of the given
+	/// dependency by their hashes, leaving out the revision they were built
+	/// from.
+	private static func builtProducts(of dependency: Dependency, rootDirectoryURL: URL) -> String {
+		guard let versionFile = VersionFile(url: VersionFile.url(for: dependency, rootDirectoryURL: rootDirectoryURL)) else {
+			return "\(dependency.name) unbuilt"
+		}
+
+		let platforms: [(String, [CachedFramework]?)] = [
+			("Mac", versionFile.macOS),
+			("iOS", versionFile.iOS),
+			("watchOS", versionFile.watchOS),
+			("tvOS", versionFile.tvOS),
+		]
+		let frameworks = platforms.flatMap { platform, cachedFrameworks in
+			(cachedFrameworks ?? []).map { cachedFramework in
+				let location = [ platform, cachedFramework.container, cachedFramework.libraryIdentifier, cachedFramework.name ]
+					.compactMap { $0 }
+					.joined(separator: "/")
+				return "\(location)=\(cachedFramework.hash)"
+			}
+		}
+
+		return ([ dependency.name ] + frameworks).joined(separator: " ")
+	}
+}
+
+/// A content-addressed store of build products on this machine, shared by all
+/// projects, so that building the same inputs again anywhere reuses the
+/// products of the first build.
+///
+/// Products are zipped with the layout of `carthage archive`. Each archive is
+/// stored once under its own digest, and the digest of the inputs it was built
+/// from points to it:
+///
+/// ~/Library/Caches/org.carthage.CarthageKit/BuildCache/inputs/7d1a5e…
+/// ~/Library/Caches/org.carthage.CarthageKit/BuildCache/objects/3f/3f09c2….zip
+///
+/// The modification date of an inputs entry records when it was last used,
+/// so that archives which aren't worth keeping anymore can be pruned.
+public struct LocalBuildCache {
+	public let directoryURL: URL
+
+	/// Whether to hash archives again, even if they haven't changed since they
+	/// were last hashed.
+	public let rehashBinaries: Bool
+
+	public init(directoryURL: URL = Constants.Dependency.buildCacheURL, rehashBinaries: Bool = false) {
+		self.directoryURL = directoryURL
+		self.rehashBinaries = rehashBinaries
+	}
+
+	/// The file URL of the entry which points the given build inputs to an
+	/// archive.
+	func inputsURL(for inputs: String) -> URL {
+		return directoryURL
+			.appendingPathComponent("inputs", isDirectory: true)
+			.appendingPathComponent(inputs, isDirectory: false)
+	}
+
+	/// The file URL of the archive with the given digest.
+	func objectURL(for digest: String) -> URL {
+		return directoryURL
+			.appendingPathComponent("objects", isDirectory: true)
+			.appendingPathComponent(String(digest.prefix(2)), isDirectory: true)
+			.appendingPathComponent("\(digest).zip", isDirectory: false)
+	}
+
+	/// Returns the file URL of the archive built from the given inputs, if
+	/// there is one and it's intact. The archive stays owned by the cache.
+	func archiveURL(forInputs inputs: String) -> URL? {
+		let entryURL = inputsURL(for: inputs)
+		guard let digest = (try? String(contentsOf: entryURL, encoding: .utf8))?.trimmingCharacters(in: .whitespacesAndNewlines) else {
+			return nil
+		}
+
+		let archiveURL = objectURL(for: digest)
+		guard verifyCachedBinary(at: archiveURL, expectedSHA256: digest, rehash: rehashBinaries) else {
+			try? FileManager.default.removeItem(at: entryURL)
+			return nil
+		}
+
+		_ = try? FileManager.default.setAttributes([ .modificationDate: Date() ], ofItemAtPath: entryURL.path)
+		return archiveURL
+	}
+
+	/// Copies the archive at the given file URL into the store, unless an
+	/// identical one is already there, and points the given inputs to it.
+	@discardableResult
+	func store(_ archiveURL: URL, forInputs inputs: String) -> Result<(), CarthageError> {
+		return sha256Digest(ofFileAt: archiveURL).flatMap { digest in
+			let destinationURL = objectURL(for: digest)
+
+			let storeArchive: Result<(), CarthageError>
+			if verifyCachedBinary(at: destinationURL, expectedSHA256: digest, rehash: rehashBinaries) {
+				storeArchive = .success(())
+			} else {
+				storeArchive = Result(at: destinationURL, attempt: {
+					let fileManager = FileManager.default
+					try fileManager.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+
+					// Copy next to the destination first, so that concurrent
+					// readers never see a partially written archive.
+					let stagingURL = $0.deletingLastPathComponent()
+						.appendingPathComponent(".\(UUID().uuidString).zip", isDirectory: false)
+					try fileManager.copyItem(at: archiveURL, to: stagingURL)
+					do {
+						_ = try fileManager.replaceItemAt($0, withItemAt: stagingURL)
+					} catch {
+						try? fileManager.removeItem(at: stagingURL)
+						throw error
+					}
+				})
+				.flatMap { recordCachedBinaryDigest(at: destinationURL, expectedSHA256: digest) }
+			}
+
+			return storeArchive.flatMap {
+				Result(at: inputsURL(for: inputs), attempt: {
+					try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+					try digest.write(to: $0, atomically: true, encoding: .utf8)
+				})
+			}
+		}
+	}
+	/// Removes the archives that the given policy doesn't allow to keep, least
+	/// recently used first, along with the inputs which point to them.
+	///
+	/// An archive counts as used whenever any of the inputs pointing to it
+	/// is.
+	///
+	/// Sends the file URL of each archive once it has been removed.
+	public func prune(_ policy: DerivedDataPolicy, now: Date = Date()) -> SignalProducer<URL, CarthageError> {
+		return SignalProducer { () -> Result<[CachedObject], CarthageError> in
+				let objects = self.objects()
+				return .success(policy.itemsToRemove(objects, lastUsed: { $0.lastUsed }, size: { $0.size }, now: now))
+			}
+			.flatten()
+			.filterMap { object -> URL? in
+				let fileManager = FileManager.default
+				guard (try? fileManager.removeItem(at: object.url)) != nil else {
+					return nil
+				}
+
+				BinaryHashCache.removeEntry(forFileAt: object.url)
+				object.inputsURLs.forEach { _ = try? fileManager.removeItem(at: $0) }
+				return object.url
+			}
+	}
+
+	/// Lists the archives in the store, along with the inputs which point to
+	/// them.
+	private func objects() -> [CachedObject] {
+		let fileManager = FileManager.default
+		let keys: [URLResourceKey] = [ .contentModificationDateKey, .totalFileAllocatedSizeKey ]
+
+		func contents(of url: URL) -> [URL] {
+			return (try? fileManager.contentsOfDirectory(at: url, includingPropertiesForKeys: keys, options: [ .skipsHiddenFiles ])) ?? []
+		}
+
+		func modificationDate(of url: URL) -> Date {
+			return (try? url.resourceValues(forKeys: [ .contentModificationDateKey ]))?.contentModificationDate ?? .distantPast
+		}
+
+		var inputsByDigest: [String: [URL]] = [:]
+		for entryURL in contents(of: directoryURL.appendingPathComponent("inputs", isDirectory: true)) {
+			guard let digest = (try? String(contentsOf: entryURL, encoding: .utf8))?.trimmingCharacters(in: .whitespacesAndNewlines) else {
+				continue
+			}
+			inputsByDigest[digest, default: []].append(entryURL)
+		}
+
+		return contents(of: directoryURL.appendingPathComponent("objects", isDirectory: true))
+			.flatMap(contents(of:))
+			.filter { $0.pathExtension == "zip" }
+			.map { objectURL in
+				let inputsURLs = inputsByDigest[objectURL.deletingPathExtension().lastPathComponent] ?? []
+				let lastUsed = ([ objectURL ] + inputsURLs).map(modificationDate(of:)).max() ?? .distantPast
+				let size = (try? objectURL.resourceValues(forKeys: [ .totalFileAllocatedSizeKey ]))?.totalFileAllocatedSize ?? 0
+
+				return CachedObject(url: objectURL, inputsURLs: inputsURLs, lastUsed: lastUsed, size: UInt64(size))
+			}
+	}
+}
+
+/// An archive in the build cache.
+private struct CachedObject {
+	let url: URL
+
+	/// The file URLs of the inputs entries which point to the archive.
+	let inputsURLs: [URL]
+
+	let lastUsed: Date
+	let size: UInt64
+}
@@ -18,6 +18,25 @@ public struct BuildOptions {
 	public var useBinaries: Bool
 	/// Whether to create an XCFramework instead of lipoing built products.
 	public var useXCFrameworks: Bool
+	/// The location of the shared artifact cache (an `http(s)://` URL, a
+	/// `file://` URL or a path) to fetch builds from and upload builds to.
+	public var artifactCacheURL: String?
+	/// The maximum number of dependencies to build concurrently.
+	public var jobs: Int
+	/// The path to write a JSON summary of the time spent in each build phase
+	/// to.
+	public var timingReportPath: String?
+	/// The path to write the build phases to as a Chrome trace.
+	public var timingTracePath: String?
+	/// Records the build phases, if a timing report or trace was requested.
+	public var timeline: BuildTimeline?
+	/// Whether dependencies share Clang and Swift module caches.
+	public var useSharedModuleCache: Bool
+	/// Whether to hash cached framework binaries again even when they haven't
+	/// changed since they were last hashed.
+	public var rehashBinaries: Bool
+	/// The path to the module cache shared by the dependencies being built.
+	internal var moduleCachePath: String?
 
 	public init(
 		configuration: String,
@@ -26,7 +45,13 @@ public struct BuildOptions {
 		derivedDataPath: String? = nil,
 		cacheBuilds: Bool = true,
 		useBinaries: Bool = true,
-		useXCFrameworks: Bool = false
+		useXCFrameworks: Bool = false,
+		artifactCacheURL: String? = nil,
+		jobs: Int = 1,
+		timingReportPath: String? = nil,
+		timingTracePath: String? = nil,
+		useSharedModuleCache: Bool = true,
+		rehashBinaries: Bool = false
 	) {
 		self.configuration = configuration
 		self.platforms = platforms
@@ -35,5 +60,12 @@ public struct BuildOptions {
 		self.cacheBuilds = cacheBuilds
 		self.useBinaries = useBinaries
 		self.useXCFrameworks = useXCFrameworks
+		self.artifactCacheURL = artifactCacheURL
+		self.jobs = jobs
+		self.timingReportPath = timingReportPath
+		self.timingTracePath = timingTracePath
+		self.timeline = timingReportPath != nil || timingTracePath != nil ? BuildTimeline() : nil
+		self.useSharedModuleCache = useSharedModuleCache
+		self.rehashBinaries = rehashBinaries
 	}
 }
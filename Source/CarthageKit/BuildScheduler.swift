@@ -0,0 +1,293 @@
+import Foundation
+import ReactiveSwift
+import Result
+
+/// Admits heavyweight `xcodebuild` invocations one at a time, as long as the
+/// host has the memory and CPU to spare, so that building several of them at
+/// once speeds things up instead of thrashing.
+///
+/// A build is admitted if nothing else is running, or if
+///
+/// - fewer builds are running than it allows to run at once, which bounds
+///   the builds of dependencies, schemes and SDKs together, and
+/// - the memory reserved by the running builds plus its own estimate fits
+///   into the memory budget, and the host currently has that much memory
+///   available, and
+/// - the host isn't loaded well beyond its CPU budget by other processes.
+///
+/// Each admitted build is told how many of the CPUs in the budget it may use,
+/// which is split evenly between the builds it allows to run at once, so that
+/// the CPUs of builds running together never add up to more than the budget.
+///
+/// The memory a build needs is estimated from what builds with the same key
+/// used in previous runs. While a build runs, the growth in memory in use on
+/// the host is sampled; since that includes whatever runs alongside, the
+/// estimates err on the high side.
+internal final class BuildScheduler {
+	/// Describes the host that builds run on.
+	struct Host {
+		/// The number of CPUs that builds may use between them.
+		var cpuBudget: Int
+
+		/// The amount of memory, in bytes, that builds may reserve between
+		/// them.
+		var memoryBudget: UInt64
+
+		/// Returns the amount of memory, in bytes, which is currently free or
+		/// can be reclaimed, or nil if it can't be determined.
+		var availableMemory: () -> UInt64?
+
+		/// Returns the average number of runnable processes over the last
+		/// minute, or nil if it can't be determined.
+		var loadAverage: () -> Double?
+
+		/// The machine Carthage runs on.
+		///
+		/// The CPU budget defaults to all active processors, and can be
+		/// lowered with the `CARTHAGE_CPU_BUDGET` environment variable.
+		static let current = Host(
+			cpuBudget: ProcessInfo.processInfo.environment["CARTHAGE_CPU_BUDGET"].flatMap(Int.init)
+				?? ProcessInfo.processInfo.activeProcessorCount,
+			memoryBudget: ProcessInfo.processInfo.physicalMemory / 4 * 3,
+			availableMemory: hostAvailableMemory,
+			loadAverage: hostLoadAverage
+		)
+	}
+
+	/// The estimate for builds which haven't been measured yet, as a single
+	/// Swift compile can take a few gigabytes.
+	static let defaultMemoryEstimate: UInt64 = 2 << 30
+
+	/// The least memory any build is assumed to take, however little growth
+	/// was measured while it ran.
+	static let minimumMemoryEstimate: UInt64 = 512 << 20
+
+	/// How often waiting builds are reconsidered and running ones measured.
+	private static let pollingInterval: DispatchTimeInterval = .seconds(1)
+
+	static let shared = BuildScheduler()
+
+	private let host: Host
+	private let estimates: BuildResourceEstimates
+	private let queue = DispatchQueue(label: "org.carthage.CarthageKit.BuildScheduler")
+
+	private var running: [UUID: RunningBuild] = [:]
+	private var waiting: [WaitingBuild] = []
+	private var isPolling = false
+
+	init(host: Host = .current, estimates: BuildResourceEstimates = BuildResourceEstimates()) {
+		self.host = host
+		self.estimates = estimates
+	}
+
+	/// Starts the producer made by the given closure once a build with the
+	/// given key can be admitted, passing the number of CPUs it may use.
+	///
+	/// The build waits while `limit` builds are already running.
+	func schedule<Value, Error>(
+		key: String,
+		limit: Int,
+		_ makeProducer: @escaping (_ jobs: Int) -> SignalProducer<Value, Error>
+	) -> SignalProducer<Value, Error> {
+		return SignalProducer { observer, lifetime in
+			let identifier = UUID()
+
+			let start = { (jobs: Int) in
+				guard !lifetime.hasEnded else {
+					self.finish(identifier, succeeded: false)
+					return
+				}
+
+				lifetime += makeProducer(jobs)
+					.on(
+						failed: { _ in self.finish(identifier, succeeded: false) },
+						completed: { self.finish(identifier, succeeded: true) },
+						interrupted: { self.finish(identifier, succeeded: false) }
+					)
+					.start(observer)
+			}
+
+			self.queue.async {
+				let estimate = self.estimates[key] ?? BuildScheduler.defaultMemoryEstimate
+				self.waiting.append(WaitingBuild(identifier: identifier, key: key, estimate: estimate, limit: max(limit, 1), start: start))
+				self.admitWaitingBuilds()
+			}
+
+			lifetime += AnyDisposable {
+				self.queue.async {
+					self.waiting.removeAll { $0.identifier == identifier }
+					self.admitWaitingBuilds()
+				}
+			}
+		}
+	}
+
+	/// Admits waiting builds in order for as long as there is room. Must be
+	/// called on the queue.
+	private func admitWaitingBuilds() {
+		while let next = waiting.first, canAdmit(next) {
+			waiting.removeFirst()
+
+			let baseline = host.availableMemory()
+			running[next.identifier] = RunningBuild(key: next.key, estimate: next.estimate, baseline: baseline, peakGrowth: 0)
+
+			// Splitting by the builds running right now would hand the whole
+			// budget to the first build, and then some to each one admitted
+			// alongside it.
+			let jobs = max(1, host.cpuBudget / next.limit)
+			DispatchQueue.global().async { next.start(jobs) }
+		}
+
+		pollIfNeeded()
+	}
+
+	private func canAdmit(_ build: WaitingBuild) -> Bool {
+		if running.isEmpty {
+			return true
+		}
+		guard running.count < build.limit else {
+			return false
+		}
+
+		let reserved = running.values.reduce(0) { $0 + $1.estimate }
+		guard reserved + build.estimate <= host.memoryBudget else {
+			return false
+		}
+		if let availableMemory = host.availableMemory(), availableMemory < build.estimate {
+			return false
+		}
+		if let loadAverage = host.loadAverage(), loadAverage > Double(host.cpuBudget) * 1.5 {
+			return false
+		}
+
+		return true
+	}
+
+	private func finish(_ identifier: UUID, succeeded: Bool) {
+		queue.async {
+			guard let build = self.running.removeValue(forKey: identifier) else {
+				return
+			}
+
+			self.measure()
+			if succeeded, build.baseline != nil {
+				self.estimates.record(max(build.peakGrowth, BuildScheduler.minimumMemoryEstimate), forKey: build.key)
+			}
+
+			self.admitWaitingBuilds()
+		}
+	}
+
+	/// Samples the memory used by the running builds since they started.
+	private func measure() {
+		guard let availableMemory = host.availableMemory() else {
+			return
+		}
+
+		for (identifier, build) in running {
+			guard let baseline = build.baseline, baseline > availableMemory else {
+				continue
+			}
+			running[identifier]?.peakGrowth = max(build.peakGrowth, baseline - availableMemory)
+		}
+	}
+
+	/// Keeps measuring running builds, and reconsidering waiting ones in case
+	/// memory was freed elsewhere, for as long as there are any.
+	private func pollIfNeeded() {
+		guard !isPolling, !(running.isEmpty && waiting.isEmpty) else {
+			return
+		}
+
+		isPolling = true
+		queue.asyncAfter(deadline: .now() + BuildScheduler.pollingInterval) {
+			self.isPolling = false
+			self.measure()
+			self.admitWaitingBuilds()
+		}
+	}
+}
+
+private struct WaitingBuild {
+	let identifier: UUID
+	let key: String
+	let estimate: UInt64
+	let limit: Int
+	let start: (Int) -> Void
+}
+
+private struct RunningBuild {
+	let key: String
+	let estimate: UInt64
+	let baseline: UInt64?
+	var peakGrowth: UInt64
+}
+
+/// The memory that builds used in previous runs, persisted between runs.
+///
+/// Each new measurement is averaged with the previous estimate, so that a
+/// single unusual run doesn't dominate.
+internal final class BuildResourceEstimates {
+	private let fileURL: URL
+	private let lock = NSLock()
+	private var estimates: [String: UInt64]
+
+	init(fileURL: URL = Constants.Dependency.buildResourcesURL) {
+		self.fileURL = fileURL
+		self.estimates = (try? Data(contentsOf: fileURL))
+			.flatMap { try? JSONDecoder().decode([String: UInt64].self, from: $0) }
+			?? [:]
+	}
+
+	subscript(key: String) -> UInt64? {
+		lock.lock()
+		defer { lock.unlock() }
+
+		return estimates[key]
+	}
+
+	/// Records that a build with the given key used the given amount of
+	/// memory, and persists the updated estimates.
+	@discardableResult
+	func record(_ memory: UInt64, forKey key: String) -> Result<(), CarthageError> {
+		lock.lock()
+		let estimate = estimates[key].map { ($0 + memory) / 2 } ?? memory
+		estimates[key] = estimate
+		let snapshot = estimates
+		lock.unlock()
+
+		return Result(at: fileURL, attempt: {
+			let data = try JSONEncoder().encode(snapshot)
+			try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+}
+
+/// Returns the free, inactive and purgeable memory of the host, in bytes.
+private func hostAvailableMemory() -> UInt64? {
+	var statistics = vm_statistics64()
+	var count = mach_msg_type_number_t(MemoryLayout<vm_statistics64_data_t>.size / MemoryLayout<integer_t>.size)
+
+	let result = withUnsafeMutablePointer(to: &statistics) { pointer in
+		pointer.withMemoryRebound(to: integer_t.self, capacity: Int(count)) {
+			host_statistics64(mach_host_self(), HOST_VM_INFO64, $0, &count)
+		}
+	}
+	guard result == KERN_SUCCESS else {
+		return nil
+	}
+
+	let pages = UInt64(statistics.free_count) + UInt64(statistics.inactive_count) + UInt64(statistics.purgeable_count)
+	return pages * UInt64(vm_kernel_page_size)
+}
+
+/// Returns the load average of the host over the last minute.
+private func hostLoadAverage() -> Double? {
+	var loadAverage = [ 0.0 ]
+	guard getloadavg(&loadAverage, 1) == 1 else {
+		return nil
+	}
+
+	return loadAverage[0]
+}
@@ -30,15 +30,6 @@ public struct BuildSettings {
 		self.action = action
 	}
 
-	/// Matches lines of the forms:
-	///
-	/// Build settings for action build and target "ReactiveCocoaLayout Mac":
-	/// Build settings for action test and target CarthageKitTests:
-	private static let targetSettingsRegex = try! NSRegularExpression( // swiftlint:disable:this force_try
-		pattern: "^Build settings for action (?:\\S+) and target \\\"?([^\":]+)\\\"?:$",
-		options: [ .caseInsensitive, .anchorsMatchLines ]
-	)
-
 	/// Invokes `xcodebuild` to retrieve build settings for the given build
 	/// arguments.
 	///
@@ -55,65 +46,51 @@ public struct BuildSettings {
 		// it is configured for the archive action.
 		let task = xcodebuildTask(["archive", "-showBuildSettings", "-skipUnavailableActions"], arguments, environment: environment)
 
-		return task.launch()
-			.ignoreTaskData()
-			.mapError(CarthageError.taskError)
-			// xcodebuild has a bug where xcodebuild -showBuildSettings
-			// can sometimes hang indefinitely on projects that don't
-			// share any schemes, so automatically bail out if it looks
-			// like that's happening.
-			.timeout(after: 60, raising: .xcodebuildTimeout(arguments.project), on: QueueScheduler(qos: .default))
-			.retry(upTo: 5)
-			.map { data in
-				return String(data: data, encoding: .utf8)!
-			}
-			.flatMap(.merge) { string -> SignalProducer<BuildSettings, CarthageError> in
-				return SignalProducer { observer, lifetime in
-					var currentSettings: [String: String] = [:]
-					var currentTarget: String?
-
-					let flushTarget = { () -> Void in
-						if let currentTarget = currentTarget {
-							let buildSettings = self.init(
-								target: currentTarget,
-								settings: currentSettings,
-								arguments: arguments,
-								action: action
-							)
-							observer.send(value: buildSettings)
-						}
-
-						currentTarget = nil
-						currentSettings = [:]
-					}
+		return SignalProducer<(), CarthageError>(value: ())
+			.map { _ in BuildSettingsCache.key(for: task, project: arguments.project) }
+			.flatMap(.concat) { cacheKey -> SignalProducer<[(target: String, settings: [String: String])], CarthageError> in
+				if let cacheKey = cacheKey, let cachedOutput = BuildSettingsCache.output(forKey: cacheKey) {
+					var parser = BuildSettingsParser()
+					parser.consume(cachedOutput)
+					return SignalProducer(value: parser.finish())
+				}
 
-					string.enumerateLines { line, stop in
-						if lifetime.hasEnded {
-							stop = true
-							return
+				return task.launch()
+					.mapError(CarthageError.taskError)
+					// Parse the output as it arrives, but only send the
+					// settings once xcodebuild has succeeded, so that a retry
+					// doesn't send them twice.
+					.reduce(into: (BuildSettingsParser(), Data())) { state, taskEvent in
+						switch taskEvent {
+						case let .standardOutput(data):
+							state.0.consume(data)
+
+						case let .success(data):
+							state.1 = data
+
+						case .launch, .standardError:
+							break
 						}
-
-						if let result = self.targetSettingsRegex.firstMatch(in: line, range: NSRange(line.startIndex..., in: line)) {
-							let targetRange = Range(result.range(at: 1), in: line)!
-
-							flushTarget()
-							currentTarget = String(line[targetRange])
-							return
+					}
+					// xcodebuild has a bug where xcodebuild -showBuildSettings
+					// can sometimes hang indefinitely on projects that don't
+					// share any schemes, so automatically bail out if it looks
+					// like that's happening.
+					.timeout(after: 60, raising: .xcodebuildTimeout(arguments.project), on: QueueScheduler(qos: .default))
+					.retry(upTo: 5)
+					.map { parser, output -> [(target: String, settings: [String: String])] in
+						if let cacheKey = cacheKey {
+							BuildSettingsCache.store(output, forKey: cacheKey)
 						}
 
-						let trimSet = CharacterSet.whitespacesAndNewlines
-						let components = line
-							.split(maxSplits: 1) { $0 == "=" }
-							.map { $0.trimmingCharacters(in: trimSet) }
-
-						if components.count == 2 {
-							currentSettings[components[0]] = components[1]
-						}
+						var parser = parser
+						return parser.finish()
 					}
-
-					flushTarget()
-					observer.sendCompleted()
-				}
+			}
+			.flatMap(.concat) { targets -> SignalProducer<BuildSettings, CarthageError> in
+				return SignalProducer(targets.map { target, settings in
+					self.init(target: target, settings: settings, arguments: arguments, action: action)
+				})
 			}
 	}
 
@@ -403,11 +380,12 @@ extension SDK {
 }
 
 extension SDK {
-	/// - See: `SDK.setFromJSONShowSDKs`
+	/// - See: `SDK.setFromJSONShowSDKs`, whose output is kept in the
+	///        `ToolchainCache` between runs.
 	/// - Note: Fallbacks are `SDK.setFromFallbackXcodeprojBuildSettings` and
 	///         hardcoded `SDK.knownIn2019YearSDKs`.
 	static let setsFromJSONShowSDKsWithFallbacks: SignalProducer<Set<SDK>, NoError> =
-		SDK.setFromJSONShowSDKs
+		SDK.parseJSONShowSDKs(ToolchainCache.output(of: SDK.jsonShowSDKsTask).map { TaskEvent.success($0) })
 			.concat(SDK.setFromFallbackXcodeprojBuildSettings)
 			.skip(while: { $0 == nil })
 			.take(first: 1)
@@ -0,0 +1,297 @@
+import Foundation
+import ReactiveTask
+import Result
+import XCDBLD
+
+/// Persists the output of `xcodebuild -showBuildSettings` between runs, so
+/// that unchanged projects don't have to be queried again.
+///
+/// Entries are keyed by the exact `xcodebuild` invocation, the selected Xcode,
+/// the contents of the projects and workspaces next to the project and of the
+/// configuration files they refer to, and what `xcodebuild` inherits from the
+/// environment, so that any change to those is picked up.
+///
+/// As the invocation includes the derived data path, which differs for each
+/// revision of a dependency, entries pile up as dependencies are updated.
+/// `prune-derived-data` removes the ones which haven't been used as long as
+/// derived data may go unused.
+internal struct BuildSettingsCache {
+	/// Bumped whenever the format of keys or entries changes.
+	private static let formatVersion = 2
+
+	/// The extensions of the files within projects and workspaces that build
+	/// settings and schemes are derived from.
+	private static let projectFileExtensions: Set<String> = [ "pbxproj", "xcscheme", "xcworkspacedata" ]
+
+	/// The extensions of projects and workspaces.
+	private static let bundleExtensions: Set<String> = [ "xcodeproj", "xcworkspace" ]
+
+	/// The extensions of directories that can't contain projects, and are
+	/// therefore not searched.
+	private static let skippedDirectoryExtensions: Set<String> = [ "framework", "xcframework", "dSYM", "xcarchive", "app", "xcassets", "lproj" ]
+
+	/// The environment variables which `xcodebuild` picks up as build
+	/// settings, or which select what it builds with, that are commonly set
+	/// in the environment. `XCODE_XCCONFIG_FILE` is described by the contents
+	/// of the file instead.
+	private static let inheritedVariables = [
+		"DEVELOPER_DIR", "TOOLCHAINS", "SDKROOT",
+		"ARCHS", "EXCLUDED_ARCHS", "VALID_ARCHS", "ONLY_ACTIVE_ARCH",
+		"MACOSX_DEPLOYMENT_TARGET", "IPHONEOS_DEPLOYMENT_TARGET", "TVOS_DEPLOYMENT_TARGET", "WATCHOS_DEPLOYMENT_TARGET",
+		"SWIFT_VERSION", "ENABLE_BITCODE",
+	]
+
+	/// The fingerprints of the project files in each directory, computed at
+	/// most once per run.
+	private static var fingerprintsByDirectory: [String: String] = [:]
+	private static let fingerprintsLock = NSLock()
+
+	/// Identifies the Xcode that `xcrun` selects.
+	static let xcodeFingerprint: String? = ToolchainCache.xcodeVersion.map { xcodeVersion in
+		let developerDirectory = ProcessInfo.processInfo.environment["DEVELOPER_DIR"] ?? ""
+		return "\(xcodeVersion.version) (\(xcodeVersion.buildVersion)) \(developerDirectory)"
+	}
+
+	/// Constructs the file URL of the cache entry with the given key.
+	///
+	/// ~/Library/Caches/org.carthage.CarthageKit/BuildSettings/7d1a5e….txt
+	static func fileURL(forKey key: String, directoryURL: URL = Constants.Dependency.buildSettingsURL) -> URL {
+		return directoryURL.appendingPathComponent("\(key).txt", isDirectory: false)
+	}
+
+	/// Computes the key for the output of the given `xcodebuild` task, which
+	/// queries the settings of the given project, or nil if its output
+	/// shouldn't be cached.
+	static func key(for task: Task, project: ProjectLocator) -> String? {
+		guard
+			let xcodeFingerprint = xcodeFingerprint,
+			let projectFingerprint = fingerprint(ofProjectFilesIn: project.fileURL.deletingLastPathComponent()),
+			let environmentFingerprint = inheritedXCConfigFingerprint(environment: task.environment ?? ProcessInfo.processInfo.environment)
+		else {
+			return nil
+		}
+
+		let environment = (task.environment ?? [:])
+			.sorted { $0.key < $1.key }
+			.map { "\($0.key)=\($0.value)" }
+		let components = [ "\(formatVersion)", xcodeFingerprint, projectFingerprint, environmentFingerprint, task.launchPath ]
+			+ task.arguments
+			+ environment
+
+		return sha256HexDigest(of: components.joined(separator: "\n"))
+	}
+
+	/// Describes what `xcodebuild` inherits from the given environment: the
+	/// variables it picks up as build settings, and the contents of the
+	/// `XCODE_XCCONFIG_FILE` and of the files it includes.
+	///
+	/// Returns nil if `XCODE_XCCONFIG_FILE` is set but can't be read.
+	static func inheritedXCConfigFingerprint(environment: [String: String] = ProcessInfo.processInfo.environment) -> String? {
+		let variables = inheritedVariables.compactMap { name in environment[name].map { "\(name)=\($0)" } }
+
+		guard let path = environment["XCODE_XCCONFIG_FILE"], !path.isEmpty else {
+			return sha256HexDigest(of: (variables + [ "XCODE_XCCONFIG_FILE none" ]).joined(separator: "\n"))
+		}
+
+		var visitedPaths = Set<String>()
+		guard let xcconfigFingerprint = fingerprint(ofXCConfigAt: URL(fileURLWithPath: path), visitedPaths: &visitedPaths) else {
+			return nil
+		}
+
+		return sha256HexDigest(of: (variables + [ "XCODE_XCCONFIG_FILE \(path) \(xcconfigFingerprint)" ]).joined(separator: "\n"))
+	}
+
+	/// Digests the contents of the configuration file at the given URL and of
+	/// those it includes, or returns nil if it can't be read.
+	///
+	/// Files which are included optionally (with `#include?`) and don't exist
+	/// are described as missing. Paths in angle brackets refer to Xcode's own
+	/// files, which are covered by the Xcode fingerprint.
+	private static func fingerprint(ofXCConfigAt url: URL, visitedPaths: inout Set<String>) -> String? {
+		let path = url.resolvingSymlinksInPath().path
+		guard visitedPaths.insert(path).inserted else {
+			return "cycle"
+		}
+		guard let data = try? Data(contentsOf: url), let contents = String(data: data, encoding: .utf8) else {
+			return nil
+		}
+
+		var lines = [ sha256HexDigest(of: contents) ]
+		for line in contents.components(separatedBy: .newlines) {
+			let trimmedLine = line.trimmingCharacters(in: .whitespaces)
+			guard trimmedLine.hasPrefix("#include") else {
+				continue
+			}
+
+			let isOptional = trimmedLine.hasPrefix("#include?")
+			let quotedParts = trimmedLine.components(separatedBy: "\"")
+			guard quotedParts.count >= 3, !quotedParts[1].isEmpty, !quotedParts[1].hasPrefix("<") else {
+				continue
+			}
+
+			let includedURL = URL(fileURLWithPath: quotedParts[1], relativeTo: url.deletingLastPathComponent()).standardizedFileURL
+			if let includedFingerprint = fingerprint(ofXCConfigAt: includedURL, visitedPaths: &visitedPaths) {
+				lines.append("\(quotedParts[1]) \(includedFingerprint)")
+			} else if isOptional && !FileManager.default.fileExists(atPath: includedURL.path) {
+				lines.append("\(quotedParts[1]) missing")
+			} else {
+				return nil
+			}
+		}
+
+		return sha256HexDigest(of: lines.joined(separator: "\n"))
+	}
+
+	/// Finds the configuration files which the given project file refers to.
+	///
+	/// Paths are resolved relative to the directory of the project, which
+	/// holds for the usual `../Configuration/Base.xcconfig`. Paths relative to
+	/// a group which don't resolve that way are matched by name against the
+	/// given configuration files found next to the project.
+	private static func xcconfigURLs(referencedBy projectFileURL: URL, candidatesByName: [String: [URL]]) -> [URL] {
+		guard let contents = try? String(contentsOf: projectFileURL, encoding: .utf8) else {
+			return []
+		}
+
+		// project.pbxproj is in Project.xcodeproj, next to which its paths start.
+		let sourceRootURL = projectFileURL.deletingLastPathComponent().deletingLastPathComponent()
+
+		let urls = contents.components(separatedBy: ";")
+			.flatMap { statement -> [URL] in
+				let parts = statement.components(separatedBy: "path = ")
+				guard parts.count == 2 else {
+					return []
+				}
+
+				let path = parts[1].trimmingCharacters(in: CharacterSet.whitespacesAndNewlines.union(CharacterSet(charactersIn: "\"")))
+				guard path.hasSuffix(".xcconfig") else {
+					return []
+				}
+
+				let url = URL(fileURLWithPath: path, relativeTo: sourceRootURL).standardizedFileURL
+				if FileManager.default.fileExists(atPath: url.path) {
+					return [ url ]
+				}
+				return candidatesByName[url.lastPathComponent] ?? []
+			}
+
+		var seenPaths = Set<String>()
+		return urls.filter { seenPaths.insert($0.path).inserted }
+	}
+
+	/// Reads the cached output for the given key, if there is one, and marks
+	/// it as used.
+	static func output(forKey key: String, directoryURL: URL = Constants.Dependency.buildSettingsURL) -> Data? {
+		return CacheDirectory.contents(ofEntryAt: fileURL(forKey: key, directoryURL: directoryURL))
+	}
+
+	/// Writes the output for the given key.
+	@discardableResult
+	static func store(_ output: Data, forKey key: String, directoryURL: URL = Constants.Dependency.buildSettingsURL) -> Result<(), CarthageError> {
+		return Result(at: fileURL(forKey: key, directoryURL: directoryURL), attempt: {
+			try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+			try output.write(to: $0, options: .atomic)
+		})
+	}
+
+	/// Digests the paths and contents of the projects and workspaces below the
+	/// given directory, and of the configuration files they refer to, or
+	/// returns nil if the directory can't be read.
+	///
+	/// Symlinked directories aren't followed, and `Carthage/Checkouts` and
+	/// `Carthage/Build` aren't searched, so that changes to other checkouts
+	/// don't change the fingerprint of this one.
+	static func fingerprint(ofProjectFilesIn directoryURL: URL) -> String? {
+		let path = directoryURL.resolvingSymlinksInPath().path
+
+		fingerprintsLock.lock()
+		defer { fingerprintsLock.unlock() }
+
+		if let fingerprint = fingerprintsByDirectory[path] {
+			return fingerprint
+		}
+
+		guard let fingerprint = computeFingerprint(ofProjectFilesIn: directoryURL) else {
+			return nil
+		}
+
+		fingerprintsByDirectory[path] = fingerprint
+		return fingerprint
+	}
+
+	/// Discards the fingerprints computed so far, so that project files are
+	/// read again.
+	static func invalidateFingerprints() {
+		fingerprintsLock.lock()
+		defer { fingerprintsLock.unlock() }
+
+		fingerprintsByDirectory.removeAll()
+	}
+
+	private static func computeFingerprint(ofProjectFilesIn directoryURL: URL) -> String? {
+		let fileManager = FileManager.default
+		let rootPath = directoryURL.path + "/"
+		let skippedPaths: Set<String> = [ Constants.checkoutsFolderPath, Constants.binariesFolderPath ]
+		let keys: [URLResourceKey] = [ .isDirectoryKey, .isSymbolicLinkKey ]
+		var bundleURLs: [URL] = []
+		var xcconfigURLsByName: [String: [URL]] = [:]
+
+		func contents(of url: URL) -> [URL]? {
+			return (try? fileManager.contentsOfDirectory(at: url, includingPropertiesForKeys: keys, options: [ .skipsHiddenFiles ]))?
+				.sorted { $0.lastPathComponent < $1.lastPathComponent }
+		}
+
+		// Finds the projects and workspaces, and the configuration files they
+		// may refer to, without following symlinks into other checkouts.
+		func visit(_ url: URL) -> Bool {
+			guard let contents = contents(of: url) else {
+				return false
+			}
+
+			for entryURL in contents {
+				let values = try? entryURL.resourceValues(forKeys: Set(keys))
+				let relativePath = entryURL.path.stripping(prefix: rootPath)
+
+				if values?.isDirectory == true && values?.isSymbolicLink != true {
+					if bundleExtensions.contains(entryURL.pathExtension) {
+						bundleURLs.append(entryURL)
+					} else if !skippedDirectoryExtensions.contains(entryURL.pathExtension) && !skippedPaths.contains(relativePath) {
+						_ = visit(entryURL)
+					}
+				} else if entryURL.pathExtension == "xcconfig" {
+					xcconfigURLsByName[entryURL.lastPathComponent, default: []].append(entryURL)
+				}
+			}
+
+			return true
+		}
+
+		guard visit(directoryURL) else {
+			return nil
+		}
+
+		var lines: [String] = []
+		for bundleURL in bundleURLs {
+			let enumerator = fileManager.enumerator(at: bundleURL, includingPropertiesForKeys: nil, options: [ .skipsHiddenFiles ])
+			let fileURLs = (enumerator?.compactMap { $0 as? URL } ?? [])
+				.filter { projectFileExtensions.contains($0.pathExtension) }
+				.sorted { $0.path < $1.path }
+
+			for fileURL in fileURLs {
+				let digest = sha256Digest(ofFileAt: fileURL).value ?? "unreadable"
+				lines.append("\(fileURL.path.stripping(prefix: rootPath)) \(digest)")
+				guard fileURL.pathExtension == "pbxproj" else {
+					continue
+				}
+
+				for xcconfigURL in xcconfigURLs(referencedBy: fileURL, candidatesByName: xcconfigURLsByName) {
+					var visitedPaths = Set<String>()
+					let digest = fingerprint(ofXCConfigAt: xcconfigURL, visitedPaths: &visitedPaths) ?? "unreadable"
+					lines.append("\(fileURL.path.stripping(prefix: rootPath)) -> \(xcconfigURL.path.stripping(prefix: rootPath)) \(digest)")
+				}
+			}
+		}
+
+		return sha256HexDigest(of: lines.joined(separator: "\n"))
+	}
+}
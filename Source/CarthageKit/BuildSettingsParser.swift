@@ -0,0 +1,170 @@
+import Foundation
+
+/// Incrementally parses the output of `xcodebuild -showBuildSettings`, which
+/// looks like:
+///
+///     Build settings for action archive and target "ReactiveCocoaLayout Mac":
+///         ACTION = archive
+///         AD_HOC_CODE_SIGNING_ALLOWED = NO
+///         …
+///
+/// Output is consumed in chunks, as it arrives, and scanned byte by byte
+/// rather than being decoded into one large string first. Setting names are
+/// interned, so that targets share the storage of the names they have in
+/// common.
+internal struct BuildSettingsParser {
+	/// The settings of each target which has been completely parsed, in the
+	/// order they appeared.
+	private(set) var targets: [(target: String, settings: [String: String])] = []
+
+	private var buffer: [UInt8] = []
+	private var currentTarget: String?
+	private var currentSettings: [String: String] = [:]
+	private var internedKeys: [ArraySlice<UInt8>: String] = [:]
+
+	private static let headerPrefix = Array("Build settings for action ".utf8)
+	private static let targetSeparator = Array(" and target ".utf8)
+
+	private static let newline = UInt8(ascii: "\n")
+	private static let carriageReturn = UInt8(ascii: "\r")
+	private static let equals = UInt8(ascii: "=")
+	private static let colon = UInt8(ascii: ":")
+	private static let quote = UInt8(ascii: "\"")
+	private static let space = UInt8(ascii: " ")
+	private static let tab = UInt8(ascii: "\t")
+
+	init() {}
+
+	/// Parses all complete lines in the given chunk of output, keeping any
+	/// incomplete line until more output arrives.
+	mutating func consume(_ data: Data) {
+		buffer.append(contentsOf: data)
+
+		var lineStart = buffer.startIndex
+		while let newlineIndex = buffer[lineStart...].index(of: BuildSettingsParser.newline) {
+			parseLine(buffer[lineStart..<newlineIndex])
+			lineStart = newlineIndex + 1
+		}
+
+		buffer.removeSubrange(buffer.startIndex..<lineStart)
+	}
+
+	/// Parses whatever output remains, and returns the settings of every
+	/// target.
+	mutating func finish() -> [(target: String, settings: [String: String])] {
+		if !buffer.isEmpty {
+			parseLine(buffer[...])
+			buffer.removeAll()
+		}
+
+		flushTarget()
+		return targets
+	}
+
+	private mutating func flushTarget() {
+		if let currentTarget = currentTarget {
+			targets.append((currentTarget, currentSettings))
+		}
+
+		currentTarget = nil
+		currentSettings = [:]
+	}
+
+	private mutating func parseLine(_ rawLine: ArraySlice<UInt8>) {
+		var line = rawLine
+		if line.last == BuildSettingsParser.carriageReturn {
+			line = line.dropLast()
+		}
+
+		if let target = BuildSettingsParser.targetName(inHeader: line) {
+			flushTarget()
+			currentTarget = target
+			return
+		}
+
+		// Settings before the first header don't belong to any target.
+		guard currentTarget != nil, let equalsIndex = line.index(of: BuildSettingsParser.equals) else {
+			return
+		}
+
+		let key = BuildSettingsParser.trimmingWhitespace(line[line.startIndex..<equalsIndex])
+		let valueStart = line.index(after: equalsIndex)
+		guard !key.isEmpty, valueStart < line.endIndex else {
+			return
+		}
+
+		let value = BuildSettingsParser.trimmingWhitespace(line[valueStart...])
+		currentSettings[intern(key)] = String(decoding: value, as: UTF8.self)
+	}
+
+	private mutating func intern(_ key: ArraySlice<UInt8>) -> String {
+		if let interned = internedKeys[key] {
+			return interned
+		}
+
+		// Copy the key out of the buffer, so that the buffer isn't retained.
+		let string = String(decoding: key, as: UTF8.self)
+		internedKeys[ArraySlice(Array(key))] = string
+		return string
+	}
+
+	/// Returns the name of the target if the given line is a header of the
+	/// form:
+	///
+	/// Build settings for action build and target "ReactiveCocoaLayout Mac":
+	/// Build settings for action test and target CarthageKitTests:
+	private static func targetName(inHeader line: ArraySlice<UInt8>) -> String? {
+		guard line.starts(with: headerPrefix), line.last == colon else {
+			return nil
+		}
+
+		let afterPrefix = line.dropFirst(headerPrefix.count)
+		guard let separatorIndex = firstIndex(of: targetSeparator, in: afterPrefix) else {
+			return nil
+		}
+
+		// The action is a single word.
+		let action = afterPrefix[afterPrefix.startIndex..<separatorIndex]
+		guard !action.isEmpty, !action.contains(space) else {
+			return nil
+		}
+
+		var name = line[(separatorIndex + targetSeparator.count)..<(line.endIndex - 1)]
+		if name.first == quote && name.last == quote && name.count >= 2 {
+			name = name.dropFirst().dropLast()
+		}
+
+		guard !name.isEmpty, !name.contains(quote), !name.contains(colon) else {
+			return nil
+		}
+
+		return String(decoding: name, as: UTF8.self)
+	}
+
+	private static func firstIndex(of pattern: [UInt8], in bytes: ArraySlice<UInt8>) -> Int? {
+		guard bytes.count >= pattern.count else {
+			return nil
+		}
+
+		var index = bytes.startIndex
+		while index <= bytes.endIndex - pattern.count {
+			if bytes[index..<(index + pattern.count)].elementsEqual(pattern) {
+				return index
+			}
+			index += 1
+		}
+
+		return nil
+	}
+
+	private static func trimmingWhitespace(_ bytes: ArraySlice<UInt8>) -> ArraySlice<UInt8> {
+		let isWhitespace = { (byte: UInt8) in byte == space || byte == tab || byte == carriageReturn || byte == newline }
+
+		guard let start = bytes.index(where: { !isWhitespace($0) }) else {
+			return bytes[bytes.endIndex...]
+		}
+
+		let end = bytes.lastIndex(where: { !isWhitespace($0) })!
+		return bytes[start...end]
+	}
+}
@@ -0,0 +1,266 @@
+import Foundation
+import ReactiveSwift
+import Result
+import XCDBLD
+
+/// A phase of building a dependency, whose duration is recorded in a
+/// `BuildTimeline`.
+public enum BuildPhase: String {
+	/// Finding the buildable schemes, their SDKs and build settings.
+	case settingsDiscovery = "settings-discovery"
+
+	/// Building a scheme for a simulator or macOS with `xcodebuild build`.
+	case compile
+
+	/// Building a scheme for a device with `xcodebuild archive`.
+	case archive
+
+	/// Copying the built products into the Build folder, merging them with
+	/// `lipo` or packaging them into an XCFramework.
+	case merge
+
+	/// Creating dSYMs with `dsymutil`.
+	case debugInformation = "debug-information"
+
+	/// Hashing the built frameworks and writing the version file.
+	case versionFile = "version-file"
+
+	/// Symlinking the Build folder into the checkout.
+	case symlink
+}
+
+/// A phase of building a dependency, as recorded in a `BuildTimeline`.
+public struct BuildSpan {
+	public let phase: BuildPhase
+
+	/// The name of the dependency (or of the directory of the project) being
+	/// built.
+	public let dependency: String
+
+	/// The scheme being built, if the phase belongs to one.
+	public let scheme: String?
+
+	/// The SDK being built for, if the phase belongs to one.
+	public let sdk: String?
+
+	public let start: Date
+	public let end: Date
+
+	public var duration: TimeInterval {
+		return end.timeIntervalSince(start)
+	}
+}
+
+/// Records how long each phase of a build takes, so that the time spent can be
+/// reported per dependency, scheme and SDK once the build has finished.
+///
+/// A timeline may be shared by concurrent builds.
+public final class BuildTimeline {
+	private let lock = NSLock()
+	private var recordedSpans: [BuildSpan] = []
+
+	public init() {}
+
+	/// The spans recorded so far, in the order they ended.
+	public var spans: [BuildSpan] {
+		lock.lock()
+		defer { lock.unlock() }
+
+		return recordedSpans
+	}
+
+	internal func record(_ span: BuildSpan) {
+		lock.lock()
+		defer { lock.unlock() }
+
+		recordedSpans.append(span)
+	}
+
+	/// Summarizes the recorded spans as JSON: the total time spent in each
+	/// phase, and the time spent building each dependency, slowest first, along
+	/// with its spans.
+	///
+	/// Times are given in seconds, and the starts of spans relative to the
+	/// start of the first one.
+	public func summary() -> Result<Data, CarthageError> {
+		let spans = self.spans
+		let origin = spans.map { $0.start }.min() ?? Date()
+		let end = spans.map { $0.end }.max() ?? origin
+
+		func durationsByPhase(_ spans: [BuildSpan]) -> [String: TimeInterval] {
+			return spans.reduce(into: [:]) { durations, span in
+				durations[span.phase.rawValue, default: 0] += span.duration
+			}
+		}
+
+		let dependencies = Dictionary(grouping: spans, by: { $0.dependency })
+			.map { name, spans in
+				DependencySummary(
+					name: name,
+					duration: spans.reduce(0) { $0 + $1.duration },
+					phases: durationsByPhase(spans),
+					spans: spans
+						.sorted { $0.start < $1.start }
+						.map { span in
+							SpanSummary(
+								phase: span.phase.rawValue,
+								scheme: span.scheme,
+								sdk: span.sdk,
+								start: span.start.timeIntervalSince(origin),
+								duration: span.duration
+							)
+						}
+				)
+			}
+			.sorted { $0.duration > $1.duration }
+
+		let summary = Summary(duration: end.timeIntervalSince(origin), phases: durationsByPhase(spans), dependencies: dependencies)
+		return encode(summary)
+	}
+
+	/// Converts the recorded spans into the Trace Event Format, which can be
+	/// loaded into `chrome://tracing` or Perfetto. Each dependency gets its own
+	/// track.
+	public func chromeTrace() -> Result<Data, CarthageError> {
+		let spans = self.spans.sorted { $0.start < $1.start }
+		let origin = spans.first?.start ?? Date()
+
+		var tracks: [String: Int] = [:]
+		let events = spans.map { span -> TraceEvent in
+			let track = tracks[span.dependency] ?? tracks.count + 1
+			tracks[span.dependency] = track
+
+			var args = [ "dependency": span.dependency ]
+			args["scheme"] = span.scheme
+			args["sdk"] = span.sdk
+
+			return TraceEvent(
+				name: span.phase.rawValue,
+				cat: "build",
+				ph: "X",
+				ts: Int64(span.start.timeIntervalSince(origin) * 1_000_000),
+				dur: Int64(span.duration * 1_000_000),
+				pid: 1,
+				tid: track,
+				args: args
+			)
+		}
+		let threadNames = tracks.map { dependency, track in
+			ThreadNameEvent(name: "thread_name", ph: "M", pid: 1, tid: track, args: [ "name": dependency ])
+		}
+
+		return encode(Trace(traceEvents: events, metadataEvents: threadNames))
+	}
+
+	/// Writes the summary to the given file URL.
+	public func writeSummary(to url: URL) -> Result<(), CarthageError> {
+		return summary().flatMap { write($0, to: url) }
+	}
+
+	/// Writes the Chrome trace to the given file URL.
+	public func writeChromeTrace(to url: URL) -> Result<(), CarthageError> {
+		return chromeTrace().flatMap { write($0, to: url) }
+	}
+
+	private func encode<T: Encodable>(_ value: T) -> Result<Data, CarthageError> {
+		return Result(attempt: {
+			let encoder = JSONEncoder()
+			encoder.outputFormatting = .prettyPrinted
+			return try encoder.encode(value)
+		})
+		.mapError { CarthageError.internalError(description: "Could not encode the build timeline: \($0)") }
+	}
+
+	private func write(_ data: Data, to url: URL) -> Result<(), CarthageError> {
+		return Result(at: url, attempt: {
+			try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+}
+
+private struct Summary: Encodable {
+	let duration: TimeInterval
+	let phases: [String: TimeInterval]
+	let dependencies: [DependencySummary]
+}
+
+private struct DependencySummary: Encodable {
+	let name: String
+	let duration: TimeInterval
+	let phases: [String: TimeInterval]
+	let spans: [SpanSummary]
+}
+
+private struct SpanSummary: Encodable {
+	let phase: String
+	let scheme: String?
+	let sdk: String?
+	let start: TimeInterval
+	let duration: TimeInterval
+}
+
+// swiftlint:disable identifier_name
+private struct TraceEvent: Encodable {
+	let name: String
+	let cat: String
+	let ph: String
+	let ts: Int64
+	let dur: Int64
+	let pid: Int
+	let tid: Int
+	let args: [String: String]
+}
+
+private struct ThreadNameEvent: Encodable {
+	let name: String
+	let ph: String
+	let pid: Int
+	let tid: Int
+	let args: [String: String]
+}
+// swiftlint:enable identifier_name
+
+private struct Trace: Encodable {
+	let traceEvents: [TraceEvent]
+	let metadataEvents: [ThreadNameEvent]
+
+	func encode(to encoder: Encoder) throws {
+		// Both kinds of events go into the same array.
+		var container = encoder.container(keyedBy: CodingKeys.self)
+		var events = container.nestedUnkeyedContainer(forKey: .traceEvents)
+		try metadataEvents.forEach { try events.encode($0) }
+		try traceEvents.forEach { try events.encode($0) }
+		try container.encode("ms", forKey: .displayTimeUnit)
+	}
+
+	private enum CodingKeys: String, CodingKey {
+		case traceEvents
+		case displayTimeUnit
+	}
+}
+
+extension SignalProducer {
+	/// Records the time from when the producer is started until it terminates
+	/// as a span of the given phase, if there is a timeline.
+	internal func timed(
+		_ phase: BuildPhase,
+		in timeline: BuildTimeline?,
+		dependency: String,
+		scheme: Scheme? = nil,
+		sdk: String? = nil
+	) -> SignalProducer<Value, Error> {
+		guard let timeline = timeline else {
+			return self
+		}
+
+		return SignalProducer { observer, lifetime in
+			let start = Date()
+			lifetime += self
+				.on(terminated: {
+					timeline.record(BuildSpan(phase: phase, dependency: dependency, scheme: scheme?.name, sdk: sdk, start: start, end: Date()))
+				})
+				.start(observer)
+		}
+	}
+}
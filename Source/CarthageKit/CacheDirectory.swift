@@ -0,0 +1,75 @@
+import Foundation
+import ReactiveSwift
+import Result
+
+/// A directory of cache entries which can each be recreated whenever they're
+/// missing, like the output of `xcodebuild` queries, so that the entries which
+/// haven't been used in a while can simply be removed.
+///
+/// The modification date of an entry records when it was last used, so
+/// reading an entry through `contents(ofEntryAt:)` marks it as used.
+public struct CacheDirectory {
+	public let url: URL
+
+	public init(url: URL) {
+		self.url = url
+	}
+
+	/// Reads the entry at the given file URL, if there is one, and marks it as
+	/// used.
+	static func contents(ofEntryAt fileURL: URL) -> Data? {
+		guard let data = try? Data(contentsOf: fileURL) else {
+			return nil
+		}
+
+		_ = try? FileManager.default.setAttributes([ .modificationDate: Date() ], ofItemAtPath: fileURL.path)
+		return data
+	}
+
+	/// Removes the entries below the directory which haven't been used for
+	/// the given amount of time, along with the directories that are left
+	/// empty.
+	///
+	/// Sends the file URL of each entry once it has been removed.
+	public func removeEntries(unusedFor maximumAge: TimeInterval, now: Date = Date()) -> SignalProducer<URL, CarthageError> {
+		let directoryURL = url
+		return SignalProducer { () -> Result<[URL], CarthageError> in
+				let keys: [URLResourceKey] = [ .isRegularFileKey, .contentModificationDateKey ]
+				let enumerator = FileManager.default.enumerator(at: directoryURL, includingPropertiesForKeys: keys)
+				let expiredURLs = (enumerator?.compactMap { $0 as? URL } ?? []).filter { fileURL in
+					guard
+						let values = try? fileURL.resourceValues(forKeys: Set(keys)),
+						values.isRegularFile == true,
+						let lastUsed = values.contentModificationDate
+					else {
+						return false
+					}
+
+					return now.timeIntervalSince(lastUsed) > maximumAge
+				}
+				return .success(expiredURLs)
+			}
+			.flatten()
+			.filterMap { fileURL -> URL? in
+				return (try? FileManager.default.removeItem(at: fileURL)) != nil ? fileURL : nil
+			}
+			.on(completed: {
+				removeEmptyDirectories(below: directoryURL)
+			})
+	}
+}
+
+/// Removes the directories below the given one which are empty, or only
+/// contain empty directories.
+private func removeEmptyDirectories(below directoryURL: URL) {
+	let fileManager = FileManager.default
+	let subdirectoryURLs = ((try? fileManager.contentsOfDirectory(at: directoryURL, includingPropertiesForKeys: [ .isDirectoryKey ])) ?? [])
+		.filter { (try? $0.resourceValues(forKeys: [ .isDirectoryKey ]))?.isDirectory == true }
+
+	for subdirectoryURL in subdirectoryURLs {
+		removeEmptyDirectories(below: subdirectoryURL)
+		if (try? fileManager.contentsOfDirectory(atPath: subdirectoryURL.path))?.isEmpty == true {
+			try? fileManager.removeItem(at: subdirectoryURL)
+		}
+	}
+}
@@ -0,0 +1,152 @@
+import CommonCrypto
+import Foundation
+import Result
+
+/// Computes the hexadecimal SHA-256 digest of the file at the given URL.
+///
+/// The file is mapped into memory rather than read into buffers, so that its
+/// pages go straight from the file system cache to CommonCrypto, which uses
+/// the SHA instructions of the CPU where they are available.
+internal func sha256Digest(ofFileAt url: URL) -> Result<String, CarthageError> {
+	let data: Data
+	do {
+		data = try Data(contentsOf: url, options: .alwaysMapped)
+	} catch {
+		return .failure(.readFailed(url, error as NSError))
+	}
+
+	var digester = SHA256Digester()
+	digester.update(with: data)
+	return .success(digester.finalize())
+}
+
+/// Computes a SHA-256 digest from contents which arrive in pieces, like a
+/// download.
+internal struct SHA256Digester {
+	private var context = CC_SHA256_CTX()
+
+	init() {
+		CC_SHA256_Init(&context)
+	}
+
+	/// Adds the given bytes to the digest.
+	mutating func update(with data: Data) {
+		// `CC_LONG` is 32 bits wide, so larger pieces are hashed in chunks.
+		let chunkSize = 1 << 30
+		data.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) in
+			var offset = 0
+			while offset < data.count {
+				let count = min(chunkSize, data.count - offset)
+				CC_SHA256_Update(&context, bytes + offset, CC_LONG(count))
+				offset += count
+			}
+		}
+	}
+
+	/// Returns the hexadecimal digest of the bytes added so far.
+	mutating func finalize() -> String {
+		var digest = [UInt8](repeating: 0, count: Int(CC_SHA256_DIGEST_LENGTH))
+		CC_SHA256_Final(&digest, &context)
+		return digest.map { String(format: "%02hhx", $0) }.joined()
+	}
+}
+
+/// Computes the hexadecimal SHA-256 digest of the UTF-8 representation of the
+/// given string.
+internal func sha256HexDigest(of string: String) -> String {
+	let bytes = Array(string.utf8)
+	var digest = [UInt8](repeating: 0, count: Int(CC_SHA256_DIGEST_LENGTH))
+	_ = CC_SHA256(bytes, CC_LONG(bytes.count), &digest)
+	return digest.map { String(format: "%02hhx", $0) }.joined()
+}
+
+/// Checks a file in the binaries cache against the digest recorded for it in
+/// the `BinaryHashCache` and, if given, the digest it is expected to have.
+///
+/// The file is only read if it changed since its digest was recorded, if no
+/// digest was recorded for it yet, or if `rehash` is true. Files which don't
+/// pass the check are removed, along with their record, so that they get
+/// downloaded again.
+///
+/// Returns whether the file can be used.
+internal func verifyCachedBinary(
+	at fileURL: URL,
+	expectedSHA256: String?,
+	rehash: Bool = false,
+	hashesDirectoryURL: URL = Constants.Dependency.binaryHashesURL
+) -> Bool {
+	let record = BinaryHashCache.entry(forFileAt: fileURL, directoryURL: hashesDirectoryURL)
+
+	let digest: String
+	if !rehash, let record = record, record.attributes == BinaryHashCache.attributes(ofFileAt: fileURL) {
+		digest = record.sha256
+	} else {
+		guard let current = sha256Digest(ofFileAt: fileURL).value else {
+			removeCachedBinary(at: fileURL, hashesDirectoryURL: hashesDirectoryURL)
+			return false
+		}
+
+		// A changed digest under an existing record means the file has been
+		// altered since it was downloaded.
+		if let record = record, record.sha256 != current {
+			removeCachedBinary(at: fileURL, hashesDirectoryURL: hashesDirectoryURL)
+			return false
+		}
+
+		BinaryHashCache.record(current, forFileAt: fileURL, directoryURL: hashesDirectoryURL)
+		digest = current
+	}
+
+	if let expectedSHA256 = expectedSHA256, expectedSHA256.lowercased() != digest {
+		removeCachedBinary(at: fileURL, hashesDirectoryURL: hashesDirectoryURL)
+		return false
+	}
+
+	return true
+}
+
+/// Records the digest of a file which was just moved into the binaries cache,
+/// failing (and removing the file) if it doesn't have the expected digest.
+///
+/// The file is only read if its digest isn't given, as it is when it was
+/// computed while downloading the file.
+internal func recordCachedBinaryDigest(
+	at fileURL: URL,
+	expectedSHA256: String?,
+	sha256: String? = nil,
+	hashesDirectoryURL: URL = Constants.Dependency.binaryHashesURL
+) -> Result<(), CarthageError> {
+	let digest: Result<String, CarthageError> = sha256.map { .success($0) } ?? sha256Digest(ofFileAt: fileURL)
+	return digest.flatMap { digest -> Result<(), CarthageError> in
+		if let expectedSHA256 = expectedSHA256, expectedSHA256.lowercased() != digest {
+			removeCachedBinary(at: fileURL, hashesDirectoryURL: hashesDirectoryURL)
+			return .failure(.checksumMismatch(fileURL, expected: expectedSHA256, actual: digest))
+		}
+
+		return BinaryHashCache.record(digest, forFileAt: fileURL, directoryURL: hashesDirectoryURL)
+	}
+}
+
+/// Removes a file from the binaries cache along with the record of its
+/// digest.
+internal func removeCachedBinary(at fileURL: URL, hashesDirectoryURL: URL = Constants.Dependency.binaryHashesURL) {
+	_ = try? FileManager.default.removeItem(at: fileURL)
+	BinaryHashCache.removeEntry(forFileAt: fileURL, directoryURL: hashesDirectoryURL)
+}
+
+extension URL {
+	/// The SHA-256 digest declared in the fragment of a binary URL, as in
+	/// `https://example.com/MyFramework.framework.zip#sha256=…`.
+	internal var declaredSHA256: String? {
+		guard let fragment = fragment else {
+			return nil
+		}
+
+		let prefix = "sha256="
+		guard fragment.hasPrefix(prefix) else {
+			return nil
+		}
+
+		return String(fragment.dropFirst(prefix.count))
+	}
+}
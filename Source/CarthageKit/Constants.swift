@@ -75,6 +75,55 @@ public struct Constants {
 		/// ~/Library/Caches/org.carthage.CarthageKit/binaries/
 		public static var assetsURL: URL = Constants.userCachesURL.appendingPathComponent("binaries", isDirectory: true)
 
+		/// The file URL to the directory in which GitHub release metadata for
+		/// binary lookups will be cached.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/releases/
+		public static var releasesURL: URL = Constants.userCachesURL.appendingPathComponent("releases", isDirectory: true)
+
+		/// The file URL to the directory in which the output of
+		/// `xcodebuild -showBuildSettings` will be cached.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/BuildSettings/
+		public static var buildSettingsURL: URL = Constants.userCachesURL.appendingPathComponent("BuildSettings", isDirectory: true)
+
+		/// The file URL to the directory in which the buildable schemes of
+		/// each checkout will be cached.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/Schemes/
+		public static var schemesURL: URL = Constants.userCachesURL.appendingPathComponent("Schemes", isDirectory: true)
+
+		/// The file URL to the directory in which the output of queries about
+		/// the selected Xcode and toolchains will be cached.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/Toolchains/
+		public static var toolchainsURL: URL = Constants.userCachesURL.appendingPathComponent("Toolchains", isDirectory: true)
+
+		/// The file URL to the directory in which the digests of framework
+		/// binaries and cached downloads will be recorded, keyed by the path of
+		/// each file.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/BinaryHashes/
+		public static var binaryHashesURL: URL = Constants.userCachesURL.appendingPathComponent("BinaryHashes", isDirectory: true)
+
+		/// The file URL to the directory in which build products will be stored
+		/// by the digest of the inputs they were built from.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/BuildCache/
+		public static var buildCacheURL: URL = Constants.userCachesURL.appendingPathComponent("BuildCache", isDirectory: true)
+
+		/// The file URL to the directory in which the Clang and Swift module
+		/// caches shared by builds will be stored.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/ModuleCache/
+		public static var moduleCacheURL: URL = Constants.userCachesURL.appendingPathComponent("ModuleCache", isDirectory: true)
+
+		/// The file URL to the file in which the resources used by builds will
+		/// be recorded, so that concurrent builds can be scheduled.
+		///
+		/// ~/Library/Caches/org.carthage.CarthageKit/BuildResources.json
+		public static var buildResourcesURL: URL = Constants.userCachesURL.appendingPathComponent("BuildResources.json", isDirectory: false)
+
 		/// The file URL to the directory in which cloned dependencies will be stored.
 		///
 		/// ~/Library/Caches/org.carthage.CarthageKit/dependencies/
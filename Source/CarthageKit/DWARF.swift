@@ -0,0 +1,356 @@
+import Foundation
+import MachO.loader
+
+extension MachOFile {
+	/// Returns the first producer (`DW_AT_producer`) of a compile unit in the
+	/// debug information of the file which satisfies the given predicate, or
+	/// nil if there is none.
+	///
+	/// Only the first slice is read, and of each compile unit, only the
+	/// attributes of the compile unit itself, so that this stays cheap however
+	/// much debug information there is.
+	func firstCompileUnitProducer(where predicate: (String) -> Bool) throws -> String? {
+		guard let object = slices.first?.objects.first else {
+			return nil
+		}
+
+		let reader = ByteReader(data: data)
+		guard
+			let debugInfo = try object.sectionRange(segment: "__DWARF", section: "__debug_info", reader: reader),
+			let debugAbbrev = try object.sectionRange(segment: "__DWARF", section: "__debug_abbrev", reader: reader)
+		else {
+			return nil
+		}
+
+		let sections = DWARFSections(
+			abbrev: debugAbbrev,
+			str: try object.sectionRange(segment: "__DWARF", section: "__debug_str", reader: reader),
+			strOffsets: try object.sectionRange(segment: "__DWARF", section: "__debug_str_offs", reader: reader)
+		)
+		let bigEndian = object.header.endianess == .big
+
+		var unitOffset = debugInfo.lowerBound
+		while unitOffset < debugInfo.upperBound {
+			var cursor = DWARFCursor(reader: reader, bigEndian: bigEndian, offset: unitOffset)
+			let unit = try DWARFUnitHeader(cursor: &cursor)
+			guard unit.nextUnitOffset > unitOffset, unit.nextUnitOffset <= debugInfo.upperBound else {
+				throw MachOError("has a malformed compile unit at offset \(unitOffset)")
+			}
+			unitOffset = unit.nextUnitOffset
+
+			guard unit.isCompileUnit, let producer = try unit.producer(cursor: &cursor, sections: sections) else {
+				continue
+			}
+			if predicate(producer) {
+				return producer
+			}
+		}
+
+		return nil
+	}
+}
+
+extension MachOFile.MachObject {
+	/// Finds the given section of the given segment, from the
+	/// `LC_SEGMENT(_64)` load commands of the object.
+	func sectionRange(segment segmentName: String, section sectionName: String, reader: ByteReader) throws -> Range<Int>? {
+		let bigEndian = header.endianess == .big
+		let is64Bit = header.is64BitHeader
+		let segmentCommand = UInt32(is64Bit ? LC_SEGMENT_64 : LC_SEGMENT)
+
+		// Sections follow their segment_command(_64), and have their size and
+		// offset after their names and address.
+		let (segmentSize, sectionSize, countOffset) = is64Bit ? (72, 80, 64) : (56, 68, 48)
+		for command in loadCommands where command.command == segmentCommand {
+			guard try reader.string(at: command.range.lowerBound + 8, length: 16) == segmentName else {
+				continue
+			}
+
+			let sectionCount = Int(try reader.uint32(at: command.range.lowerBound + countOffset, bigEndian: bigEndian))
+			for index in 0..<sectionCount {
+				let sectionOffset = command.range.lowerBound + segmentSize + index * sectionSize
+				guard try reader.string(at: sectionOffset, length: 16) == sectionName else {
+					continue
+				}
+
+				let size = try is64Bit
+					? Int(reader.uint64(at: sectionOffset + 40, bigEndian: bigEndian))
+					: Int(reader.uint32(at: sectionOffset + 36, bigEndian: bigEndian))
+				let offset = Int(try reader.uint32(at: sectionOffset + (is64Bit ? 48 : 40), bigEndian: bigEndian))
+				return try reader.checkedRange(range.lowerBound + offset, size)
+			}
+		}
+
+		return nil
+	}
+}
+
+/// The sections that the attributes of a compile unit refer to.
+private struct DWARFSections {
+	let abbrev: Range<Int>
+	let str: Range<Int>?
+	let strOffsets: Range<Int>?
+}
+
+/// The header of a unit in `__debug_info`.
+private struct DWARFUnitHeader {
+	let version: UInt64
+	let unitType: UInt64
+	let addressSize: Int
+
+	/// The size of section offsets: 4 bytes, or 8 in the 64-bit format.
+	let offsetSize: Int
+
+	let abbrevOffset: Int
+	let nextUnitOffset: Int
+
+	/// Whether the unit describes a compile unit, rather than types.
+	var isCompileUnit: Bool {
+		// DW_UT_compile and DW_UT_partial; before DWARF 5, type units were in
+		// a section of their own.
+		return unitType == 0x01 || unitType == 0x03
+	}
+
+	/// Reads the header at the cursor, leaving the cursor at the first entry.
+	init(cursor: inout DWARFCursor) throws {
+		var length = try cursor.unsigned(size: 4)
+		offsetSize = length == 0xffff_ffff ? 8 : 4
+		if offsetSize == 8 {
+			length = try cursor.unsigned(size: 8)
+		}
+		guard length <= UInt64(Int.max - cursor.offset) else {
+			throw MachOError("has a malformed compile unit at offset \(cursor.offset)")
+		}
+		nextUnitOffset = cursor.offset + Int(length)
+
+		version = try cursor.unsigned(size: 2)
+		switch version {
+		case 2...4:
+			unitType = 0x01
+			abbrevOffset = Int(try cursor.unsigned(size: offsetSize))
+			addressSize = Int(try cursor.unsigned(size: 1))
+
+		case 5:
+			unitType = try cursor.unsigned(size: 1)
+			addressSize = Int(try cursor.unsigned(size: 1))
+			abbrevOffset = Int(try cursor.unsigned(size: offsetSize))
+
+		default:
+			throw MachOError("has debug information of unsupported DWARF version \(version)")
+		}
+	}
+
+	/// Reads the producer of the unit's first entry, at the cursor.
+	func producer(cursor: inout DWARFCursor, sections: DWARFSections) throws -> String? {
+		let code = try cursor.uleb128()
+		guard code != 0, let attributes = try abbreviation(code, cursor: cursor, sections: sections) else {
+			return nil
+		}
+
+		var producer: DWARFAttributeValue?
+		var strOffsetsBase: UInt64?
+		for attribute in attributes {
+			let value = try readValue(of: attribute.form, implicitConstant: attribute.implicitConstant, cursor: &cursor)
+			switch attribute.name {
+			case 0x25: // DW_AT_producer
+				producer = value
+			case 0x72: // DW_AT_str_offsets_base
+				if case let .constant(base) = value {
+					strOffsetsBase = base
+				}
+			default:
+				break
+			}
+		}
+
+		switch producer {
+		case let .string(string)?:
+			return string
+
+		case let .stringOffset(offset)?:
+			return try string(atOffset: offset, cursor: cursor, sections: sections)
+
+		case let .stringIndex(index)?:
+			// Without a base, the offsets are those of the only contribution
+			// to the section, which follow its header.
+			guard let strOffsets = sections.strOffsets else {
+				return nil
+			}
+			let base = strOffsetsBase ?? UInt64(offsetSize == 8 ? 16 : 8)
+			var offsetCursor = cursor
+			offsetCursor.offset = strOffsets.lowerBound + Int(base) + Int(index) * offsetSize
+			guard offsetCursor.offset + offsetSize <= strOffsets.upperBound else {
+				throw MachOError("has a string index out of bounds")
+			}
+			return try string(atOffset: try offsetCursor.unsigned(size: offsetSize), cursor: cursor, sections: sections)
+
+		case .constant?, .other?, nil:
+			return nil
+		}
+	}
+
+	/// Finds the attributes of the abbreviation with the given code in the
+	/// unit's abbreviation table.
+	private func abbreviation(_ code: UInt64, cursor: DWARFCursor, sections: DWARFSections) throws -> [DWARFAttributeSpecification]? {
+		var abbrevCursor = cursor
+		abbrevCursor.offset = sections.abbrev.lowerBound + abbrevOffset
+
+		while abbrevCursor.offset < sections.abbrev.upperBound {
+			let abbreviationCode = try abbrevCursor.uleb128()
+			guard abbreviationCode != 0 else {
+				return nil
+			}
+			_ = try abbrevCursor.uleb128() // The tag.
+			_ = try abbrevCursor.unsigned(size: 1) // Whether there are children.
+
+			var attributes: [DWARFAttributeSpecification] = []
+			while true {
+				let name = try abbrevCursor.uleb128()
+				let form = try abbrevCursor.uleb128()
+				if name == 0 && form == 0 {
+					break
+				}
+
+				// DW_FORM_implicit_const keeps its value in the abbreviation.
+				let implicitConstant: UInt64? = try form == 0x21 ? abbrevCursor.uleb128() : nil
+				attributes.append(DWARFAttributeSpecification(name: name, form: form, implicitConstant: implicitConstant))
+			}
+
+			if abbreviationCode == code {
+				return attributes
+			}
+		}
+
+		return nil
+	}
+
+	/// Reads, or skips, a value of the given form at the cursor.
+	private func readValue(of form: UInt64, implicitConstant: UInt64?, cursor: inout DWARFCursor) throws -> DWARFAttributeValue {
+		switch form {
+		case 0x08: // DW_FORM_string
+			return .string(try cursor.cString())
+		case 0x0e: // DW_FORM_strp
+			return .stringOffset(try cursor.unsigned(size: offsetSize))
+		case 0x1a: // DW_FORM_strx
+			return .stringIndex(try cursor.uleb128())
+		case 0x25...0x28: // DW_FORM_strx1...4
+			return .stringIndex(try cursor.unsigned(size: Int(form) - 0x24))
+		case 0x17: // DW_FORM_sec_offset
+			return .constant(try cursor.unsigned(size: offsetSize))
+		case 0x21: // DW_FORM_implicit_const
+			return .constant(implicitConstant ?? 0)
+		case 0x16: // DW_FORM_indirect
+			return try readValue(of: try cursor.uleb128(), implicitConstant: implicitConstant, cursor: &cursor)
+
+		case 0x0b, 0x0c, 0x11, 0x29: // data1, flag, ref1, addrx1
+			try cursor.skip(1)
+		case 0x05, 0x12, 0x2a: // data2, ref2, addrx2
+			try cursor.skip(2)
+		case 0x2b: // addrx3
+			try cursor.skip(3)
+		case 0x06, 0x13, 0x1c, 0x2c: // data4, ref4, ref_sup4, addrx4
+			try cursor.skip(4)
+		case 0x07, 0x14, 0x20, 0x24: // data8, ref8, ref_sig8, ref_sup8
+			try cursor.skip(8)
+		case 0x1e: // data16
+			try cursor.skip(16)
+		case 0x01: // addr
+			try cursor.skip(addressSize)
+		case 0x10: // ref_addr, which was address sized in DWARF 2
+			try cursor.skip(version <= 2 ? addressSize : offsetSize)
+		case 0x1d, 0x1f: // strp_sup, line_strp
+			try cursor.skip(offsetSize)
+		case 0x0d, 0x0f, 0x15, 0x1b, 0x22, 0x23: // sdata, udata, ref_udata, addrx, loclistx, rnglistx
+			_ = try cursor.uleb128()
+		case 0x19: // flag_present
+			break
+		case 0x0a: // block1
+			try cursor.skip(Int(try cursor.unsigned(size: 1)))
+		case 0x03: // block2
+			try cursor.skip(Int(try cursor.unsigned(size: 2)))
+		case 0x04: // block4
+			try cursor.skip(Int(try cursor.unsigned(size: 4)))
+		case 0x09, 0x18: // block, exprloc
+			try cursor.skip(Int(try cursor.uleb128()))
+
+		default:
+			throw MachOError("has debug information of unsupported form \(form)")
+		}
+
+		return .other
+	}
+
+	private func string(atOffset offset: UInt64, cursor: DWARFCursor, sections: DWARFSections) throws -> String? {
+		guard let str = sections.str else {
+			return nil
+		}
+		guard offset < UInt64(str.count) else {
+			throw MachOError("has a string offset out of bounds")
+		}
+
+		var stringCursor = cursor
+		stringCursor.offset = str.lowerBound + Int(offset)
+		return try stringCursor.cString()
+	}
+}
+
+/// How an abbreviation encodes one attribute.
+private struct DWARFAttributeSpecification {
+	let name: UInt64
+	let form: UInt64
+	let implicitConstant: UInt64?
+}
+
+/// The value of an attribute, as far as it's of interest.
+private enum DWARFAttributeValue {
+	case string(String)
+	case stringOffset(UInt64)
+	case stringIndex(UInt64)
+	case constant(UInt64)
+	case other
+}
+
+/// Reads DWARF values one after the other.
+private struct DWARFCursor {
+	let reader: ByteReader
+	let bigEndian: Bool
+	var offset: Int
+
+	mutating func skip(_ count: Int) throws {
+		offset = try reader.checkedRange(offset, count).upperBound
+	}
+
+	mutating func unsigned(size: Int) throws -> UInt64 {
+		let range = try reader.checkedRange(offset, size)
+		offset = range.upperBound
+
+		let bytes = reader.data[range]
+		return (bigEndian ? Array(bytes) : Array(bytes.reversed())).reduce(0) { $0 << 8 | UInt64($1) }
+	}
+
+	mutating func uleb128() throws -> UInt64 {
+		var value: UInt64 = 0
+		var shift: UInt64 = 0
+		while true {
+			let byte = try unsigned(size: 1)
+			if shift < 64 {
+				value |= (byte & 0x7f) << shift
+			}
+			shift += 7
+
+			if byte & 0x80 == 0 {
+				return value
+			}
+		}
+	}
+
+	mutating func cString() throws -> String {
+		guard offset < reader.data.count, let end = reader.data[offset...].firstIndex(of: 0) else {
+			throw MachOError("has an unterminated string at offset \(offset)")
+		}
+
+		let string = String(decoding: reader.data[offset..<end], as: UTF8.self)
+		offset = end + 1
+		return string
+	}
+}
@@ -0,0 +1,281 @@
+import Foundation
+import ReactiveSwift
+import Result
+
+/// Limits on how much derived data is kept around.
+public struct DerivedDataPolicy {
+	/// The most space, in bytes, that derived data may take up, if it's
+	/// limited.
+	public var maximumSize: UInt64?
+
+	/// How long derived data may go unused before it's removed, if that's
+	/// limited.
+	public var maximumAge: TimeInterval?
+
+	public init(maximumSize: UInt64? = nil, maximumAge: TimeInterval? = nil) {
+		self.maximumSize = maximumSize
+		self.maximumAge = maximumAge
+	}
+
+	/// Chooses the items to remove under this policy: those which have gone
+	/// unused for too long, and then the least recently used ones until the
+	/// rest fit into the size limit. Items which have been used within the
+	/// grace period are kept regardless.
+	internal func itemsToRemove<Item>(
+		_ items: [Item],
+		lastUsed: (Item) -> Date,
+		size: (Item) -> UInt64,
+		now: Date
+	) -> [Item] {
+		let removableItems = items
+			.filter { now.timeIntervalSince(lastUsed($0)) > DerivedDataStore.gracePeriod }
+			.sorted { lastUsed($0) < lastUsed($1) }
+
+		var itemsToRemove: [Item] = []
+		var remainingSize = items.reduce(0) { $0 + size($1) }
+
+		for item in removableItems {
+			let isExpired = maximumAge.map { now.timeIntervalSince(lastUsed(item)) > $0 } ?? false
+			let isOverBudget = maximumSize.map { remainingSize > $0 } ?? false
+			guard isExpired || isOverBudget else {
+				continue
+			}
+
+			itemsToRemove.append(item)
+			remainingSize -= size(item)
+		}
+
+		return itemsToRemove
+	}
+}
+
+/// The derived data of building one revision of a dependency with one
+/// version of Xcode.
+public struct DerivedDataEntry {
+	/// The file URL of the directory of the entry.
+	public let url: URL
+
+	/// When the entry was last built into.
+	public let lastUsed: Date
+
+	/// The space the entry takes up, in bytes.
+	public let size: UInt64
+}
+
+/// Keeps track of when the derived data of each dependency was last used, so
+/// that derived data which isn't worth keeping anymore can be removed, least
+/// recently used first.
+///
+/// Derived data is laid out by Xcode version, dependency and revision:
+///
+/// ~/Library/Caches/org.carthage.CarthageKit/DerivedData/12.4_12D4e/Alamofire/5.4.1/
+///
+/// Each entry records when it was last used, and how much space it took up
+/// then, in a file of its own. That way, pruning doesn't have to go through
+/// all of derived data to find out what to remove, and builds of different
+/// projects don't have to coordinate.
+public struct DerivedDataStore {
+	/// The name of the file in which each entry records its use.
+	static let usageFileName = ".carthage-usage"
+
+	/// Entries which have been used this recently are never removed, as they
+	/// may be in use by a build.
+	static let gracePeriod: TimeInterval = 60 * 60
+
+	public let directoryURL: URL
+
+	/// Whether everything in the directory is Carthage's, so that directories
+	/// which haven't recorded their use, like those built into before uses
+	/// were recorded, are entries too.
+	public let adoptsUnrecordedEntries: Bool
+
+	/// Creates a store for the given directory. Unless told otherwise, only
+	/// Carthage's own derived data folder adopts entries which haven't
+	/// recorded their use.
+	public init(directoryURL: URL = Constants.Dependency.derivedDataURL, adoptsUnrecordedEntries: Bool? = nil) {
+		self.directoryURL = directoryURL
+		self.adoptsUnrecordedEntries = adoptsUnrecordedEntries
+			?? (directoryURL.standardizedFileURL.path == Constants.Dependency.derivedDataURL.standardizedFileURL.path)
+	}
+
+	/// The file URL of the directory for building the given revision of a
+	/// dependency with the given version of Xcode into.
+	public func derivedDataURL(xcodeVersion: String, dependencyName: String, commitish: String) -> URL {
+		return directoryURL
+			.appendingPathComponent(xcodeVersion, isDirectory: true)
+			.appendingPathComponent(dependencyName, isDirectory: true)
+			.appendingPathComponent(commitish, isDirectory: true)
+	}
+
+	/// Records that the derived data in the given directory is being used.
+	///
+	/// If `measuringSize` is true, the space the entry takes up is measured
+	/// as well. Otherwise, whatever was measured before is kept.
+	@discardableResult
+	public func recordUse(of derivedDataURL: URL, measuringSize: Bool, at date: Date = Date()) -> Result<(), CarthageError> {
+		guard let entryURL = entryURL(containing: derivedDataURL) else {
+			return .success(())
+		}
+
+		let size = measuringSize ? allocatedSize(of: entryURL) : usage(of: entryURL)?.size
+		return write(DerivedDataUsage(lastUsed: date, size: size), for: entryURL)
+	}
+
+	/// Lists the entries in the store.
+	///
+	/// Only directories which have recorded their use are entries, so that
+	/// derived data which Carthage didn't build into, like Xcode's own when
+	/// it's shared through `--derived-data`, is never listed or removed.
+	///
+	/// If the store adopts unrecorded entries, directories without a record
+	/// are considered to have last been used when they were last modified,
+	/// and get a record of their own. Entries which haven't recorded their
+	/// size are measured once.
+	public func entries() -> [DerivedDataEntry] {
+		let fileManager = FileManager.default
+
+		func subdirectories(of url: URL) -> [URL] {
+			let contents = (try? fileManager.contentsOfDirectory(
+				at: url,
+				includingPropertiesForKeys: [ .isDirectoryKey ],
+				options: [ .skipsHiddenFiles ]
+			)) ?? []
+
+			return contents.filter { (try? $0.resourceValues(forKeys: [ .isDirectoryKey ]))?.isDirectory == true }
+		}
+
+		let entryURLs = subdirectories(of: directoryURL)
+			.flatMap(subdirectories(of:))
+			.flatMap(subdirectories(of:))
+
+		return entryURLs.compactMap { entryURL in
+			let recordedUsage = self.usage(of: entryURL)
+				?? (adoptsUnrecordedEntries ? DerivedDataUsage(lastUsed: modificationDate(of: entryURL) ?? Date(), size: nil) : nil)
+			guard var usage = recordedUsage else {
+				return nil
+			}
+
+			let size: UInt64
+			if let recordedSize = usage.size {
+				size = recordedSize
+			} else {
+				size = allocatedSize(of: entryURL)
+				usage.size = size
+				_ = write(usage, for: entryURL)
+			}
+
+			return DerivedDataEntry(url: entryURL, lastUsed: usage.lastUsed, size: size)
+		}
+	}
+
+	/// Removes the entries that the given policy doesn't allow to keep: those
+	/// which have gone unused for too long, and then the least recently used
+	/// ones until the rest fit into the size limit.
+	///
+	/// Sends each entry once it has been removed.
+	public func prune(_ policy: DerivedDataPolicy, now: Date = Date()) -> SignalProducer<DerivedDataEntry, CarthageError> {
+		return SignalProducer { () -> Result<[DerivedDataEntry], CarthageError> in
+				return .success(self.entriesToRemove(self.entries(), policy: policy, now: now))
+			}
+			.flatten()
+			.attemptMap { entry -> Result<DerivedDataEntry, CarthageError> in
+				return self.remove(entry).map { entry }
+			}
+			.on(value: { entry in
+				self.removeEmptyDirectories(above: entry.url)
+			})
+	}
+
+	/// Chooses the entries to remove under the given policy.
+	internal func entriesToRemove(_ entries: [DerivedDataEntry], policy: DerivedDataPolicy, now: Date) -> [DerivedDataEntry] {
+		return policy.itemsToRemove(entries, lastUsed: { $0.lastUsed }, size: { $0.size }, now: now)
+	}
+
+	/// Returns the entry which the given directory belongs to, or nil if it
+	/// isn't within one.
+	///
+	/// Revisions like `feature/foo` are nested within one entry.
+	private func entryURL(containing url: URL) -> URL? {
+		let rootComponents = directoryURL.standardizedFileURL.pathComponents
+		let components = url.standardizedFileURL.pathComponents
+		guard components.count >= rootComponents.count + 3, Array(components.prefix(rootComponents.count)) == rootComponents else {
+			return nil
+		}
+
+		return components[rootComponents.count..<(rootComponents.count + 3)]
+			.reduce(directoryURL) { $0.appendingPathComponent($1, isDirectory: true) }
+	}
+
+	private func usageFileURL(for entryURL: URL) -> URL {
+		return entryURL.appendingPathComponent(DerivedDataStore.usageFileName, isDirectory: false)
+	}
+
+	private func usage(of entryURL: URL) -> DerivedDataUsage? {
+		return (try? Data(contentsOf: usageFileURL(for: entryURL)))
+			.flatMap { try? JSONDecoder().decode(DerivedDataUsage.self, from: $0) }
+	}
+
+	private func write(_ usage: DerivedDataUsage, for entryURL: URL) -> Result<(), CarthageError> {
+		return Result(at: usageFileURL(for: entryURL), attempt: {
+			let data = try JSONEncoder().encode(usage)
+			try FileManager.default.createDirectory(at: entryURL, withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+
+	private func remove(_ entry: DerivedDataEntry) -> Result<(), CarthageError> {
+		return Result(at: entry.url, attempt: {
+			do {
+				try FileManager.default.removeItem(at: $0)
+			} catch let error as NSError where error.domain == NSCocoaErrorDomain && error.code == NSFileNoSuchFileError {
+				// Another process pruned it first.
+			}
+		})
+	}
+
+	/// Removes the directories of the dependency and Xcode version of the
+	/// given entry if they no longer contain anything.
+	private func removeEmptyDirectories(above entryURL: URL) {
+		let fileManager = FileManager.default
+		let dependencyURL = entryURL.deletingLastPathComponent()
+
+		for url in [ dependencyURL, dependencyURL.deletingLastPathComponent() ] {
+			guard (try? fileManager.contentsOfDirectory(atPath: url.path))?.isEmpty == true else {
+				return
+			}
+			try? fileManager.removeItem(at: url)
+		}
+	}
+}
+
+/// The contents of the file in which an entry records its use.
+private struct DerivedDataUsage: Codable {
+	var lastUsed: Date
+	var size: UInt64?
+}
+
+private func modificationDate(of url: URL) -> Date? {
+	return (try? url.resourceValues(forKeys: [ .contentModificationDateKey ]))?.contentModificationDate
+}
+
+/// Adds up the space taken up by the files below the given directory.
+private func allocatedSize(of directoryURL: URL) -> UInt64 {
+	let keys: [URLResourceKey] = [ .isRegularFileKey, .totalFileAllocatedSizeKey ]
+	guard let enumerator = FileManager.default.enumerator(at: directoryURL, includingPropertiesForKeys: keys) else {
+		return 0
+	}
+
+	return enumerator
+		.compactMap { $0 as? URL }
+		.reduce(0) { size, fileURL in
+			guard
+				let values = try? fileURL.resourceValues(forKeys: Set(keys)),
+				values.isRegularFile == true,
+				let fileSize = values.totalFileAllocatedSize
+			else {
+				return size
+			}
+
+			return size + UInt64(fileSize)
+		}
+}
@@ -16,7 +16,9 @@ public enum CarthageError: Error {
 	public struct XCFrameworkRequired: Equatable {
 		let productName: String
 		let commonArchitectures: Set<String>
-		let underlyingError: TaskError
+
+		/// Why the device and simulator executables couldn't be merged.
+		let underlyingError: String
 	}
 
 	/// One or more arguments was invalid.
@@ -117,6 +119,9 @@ public enum CarthageError: Error {
 	/// 	The device and simulator slices for "(productName)" both build for: (commonArchitectures)
 	/// Rebuild with --use-xcframeworks to create an xcframework bundle instead.
 	case xcframeworkRequired(XCFrameworkRequired)
+
+	/// A downloaded or cached binary did not have the expected SHA-256 digest.
+	case checksumMismatch(URL, expected: String, actual: String)
 }
 
 extension CarthageError {
@@ -213,6 +218,9 @@ extension CarthageError: Equatable {
 		case let (.xcframeworkRequired(left), .xcframeworkRequired(right)):
 			return left == right
 
+		case let (.checksumMismatch(la, lb, lc), .checksumMismatch(ra, rb, rc)):
+			return la == ra && lb == rb && lc == rc
+
 		default:
 			return false
 		}
@@ -406,6 +414,9 @@ extension CarthageError: CustomStringConvertible {
 					"The device and simulator slices for \"\(info.productName)\" both build for: \(archs)",
 				"Rebuild with --use-xcframeworks to create an xcframework bundle instead."
 			].joined(separator: "\n")
+
+		case let .checksumMismatch(fileURL, expected, actual):
+			return "Checksum mismatch for \(fileURL.path): expected SHA-256 \(expected), got \(actual)"
 		}
 	}
 }
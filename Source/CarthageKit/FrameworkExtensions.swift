@@ -129,6 +129,30 @@ extension SignalProducer {
 			.then(SignalProducer<Bool, Error>(value: true))
 			.flatMapError { _ in .init(value: false) }
 	}
+
+	/// Restarts the producer up to `count` times when it fails with an error
+	/// matching `shouldRetry`, waiting `interval` before the first retry and
+	/// doubling the delay after each one.
+	internal func retry(
+		upTo count: Int,
+		backingOffFrom interval: TimeInterval,
+		on scheduler: DateScheduler = QueueScheduler(),
+		where shouldRetry: @escaping (Error) -> Bool
+	) -> SignalProducer<Value, Error> {
+		guard count > 0 else {
+			return self
+		}
+
+		return flatMapError { error -> SignalProducer<Value, Error> in
+			guard shouldRetry(error) else {
+				return SignalProducer(error: error)
+			}
+
+			return SignalProducer<(), Error>(value: ())
+				.delay(interval, on: scheduler)
+				.then(self.retry(upTo: count - 1, backingOffFrom: interval * 2, on: scheduler, where: shouldRetry))
+		}
+	}
 }
 
 extension SignalProducer where Value: SignalProducerProtocol, Error == Value.Error {
@@ -437,6 +461,37 @@ extension Reactive where Base: URLSession {
 				}
 			}
 
+			lifetime.observeEnded {
+				task.cancel()
+			}
+			task.resume()
+		}
+	}
+	/// Returns a SignalProducer which performs an uploadTask associated with a
+	/// `URLSession`, sending the contents of the given file as the body.
+	///
+	/// - parameters:
+	///   - request: A request that will be performed when the producer is
+	///              started
+	///   - fileURL: The file to upload.
+	///
+	/// - returns: A producer that will execute the given request once for each
+	///            invocation of `start()`.
+	///
+	/// - note: This method will not send an error event in the case of a server
+	///         side error (i.e. when a response with status code other than
+	///         200...299 is received).
+	internal func upload(with request: URLRequest, fromFile fileURL: URL) -> SignalProducer<(Data, URLResponse), AnyError> {
+		return SignalProducer { [base = self.base] observer, lifetime in
+			let task = base.uploadTask(with: request, fromFile: fileURL) { data, response, error in
+				if let response = response {
+					observer.send(value: (data ?? Data(), response))
+					observer.sendCompleted()
+				} else {
+					observer.send(error: AnyError(error ?? defaultSessionError))
+				}
+			}
+
 			lifetime.observeEnded {
 				task.cancel()
 			}
@@ -4,7 +4,7 @@ import ReactiveSwift
 import Tentacle
 
 /// The User-Agent to use for GitHub requests.
-private func gitHubUserAgent() -> String {
+internal func gitHubUserAgent() -> String {
 	let identifier = Constants.bundleIdentifier
 	let version = CarthageKitVersion.current.value
 	return "\(identifier)/\(version)"
@@ -24,6 +24,17 @@ extension Server {
 		return GitURL("ssh://git@\(url.host!)/\(repository.owner)/\(repository.name).git")
 	}
 
+	/// The base URL of the REST API of this server.
+	internal var apiURL: URL {
+		switch self {
+		case .dotCom:
+			return URL(string: "https://api.github.com")!
+
+		case let .enterprise(url):
+			return url.appendingPathComponent("api/v3")
+		}
+	}
+
 	/// The URL for filing a new GitHub issue for the given repository.
 	public func newIssueURL(for repository: Repository) -> URL {
 		return URL(string: "\(self)/\(repository.owner)/\(repository.name)/issues/new")!
@@ -142,14 +153,25 @@ private func tokenFromEnvironment(forServer server: Server) -> String? {
 	return nil
 }
 
+/// The value of the `Authorization` header to use for hand-rolled requests
+/// against the given server, mirroring the credentials `Client` would pick.
+internal func gitHubAuthorizationHeader(forServer server: Server) -> String? {
+	if let token = tokenFromEnvironment(forServer: server) {
+		return "token \(token)"
+	} else if let (username, password) = credentialsFromGit(forServer: server) {
+		let credentials = "\(username):\(password)".data(using: .utf8)!
+		return "Basic \(credentials.base64EncodedString())"
+	}
+
+	return nil
+}
+
 extension Client {
-	convenience init(server: Server, isAuthenticated: Bool = true) {
+	convenience init(server: Server, isAuthenticated: Bool = true, urlSession: URLSession = .proxiedSession) {
 		if Client.userAgent == nil {
 			Client.userAgent = gitHubUserAgent()
 		}
 
-		let urlSession = URLSession.proxiedSession
-
 		if !isAuthenticated {
 			self.init(server, urlSession: urlSession)
 		} else if let token = tokenFromEnvironment(forServer: server) {
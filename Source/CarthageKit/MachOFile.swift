@@ -0,0 +1,519 @@
+import Foundation
+import MachO.fat
+import MachO.loader
+import Result
+
+/// A Mach-O file, parsed straight from a memory map of it instead of through
+/// `lipo`, `objdump` or `otool`.
+///
+/// A file is either a universal ("fat") file with one slice per architecture,
+/// or a single slice. Each slice is a Mach-O object (an executable, a dynamic
+/// library, a bundle, a dSYM, …), or a static library whose members are.
+internal struct MachOFile {
+	/// One architecture of a Mach-O file.
+	struct Slice {
+		let cpuType: cpu_type_t
+		let cpuSubtype: cpu_subtype_t
+
+		/// Where the slice is in the file.
+		let range: Range<Int>
+
+		/// The alignment of the slice within a universal file, as a power of 2.
+		/// For thin files, the alignment `lipo` would give the slice.
+		let alignment: UInt32
+
+		/// The Mach-O objects in the slice: one, or one for each object file
+		/// in a static library.
+		let objects: [MachObject]
+
+		/// The name of the architecture, as `lipo` prints it.
+		var architecture: String {
+			return architectureName(cpuType: cpuType, cpuSubtype: cpuSubtype)
+		}
+	}
+
+	/// A Mach-O object within a slice.
+	struct MachObject {
+		let header: MachHeader
+
+		/// Where the object is in the file.
+		let range: Range<Int>
+
+		let loadCommands: [LoadCommand]
+	}
+
+	/// A load command of a Mach-O object.
+	struct LoadCommand {
+		let command: UInt32
+
+		/// Where the command, including its type and size, is in the file.
+		let range: Range<Int>
+	}
+
+	/// The contents of the file, which are memory mapped if they were read
+	/// from a file.
+	let data: Data
+
+	/// Whether the file is a universal file, even if it has only one slice.
+	let isUniversal: Bool
+
+	let slices: [Slice]
+
+	/// The names of the architectures in the file, in order.
+	var architectures: [String] {
+		return slices.map { $0.architecture }
+	}
+
+	/// Maps and parses the file at the given URL.
+	static func read(at url: URL) -> Result<MachOFile, CarthageError> {
+		return Result(at: url.resolvingSymlinksInPath(), carthageError: CarthageError.readFailed, attempt: {
+			try Data(contentsOf: $0, options: .alwaysMapped)
+		})
+		.flatMap { data in
+			MachOFile.parse(data).mapError { error in
+				CarthageError.parseError(description: "\(url.path) \(error.description)")
+			}
+		}
+	}
+
+	/// Parses the given contents of a Mach-O file.
+	static func parse(_ data: Data) -> Result<MachOFile, MachOError> {
+		do {
+			return .success(try MachOFile(data: data.startIndex == 0 ? data : Data(Array(data))))
+		} catch let error as MachOError {
+			return .failure(error)
+		} catch {
+			return .failure(MachOError("could not be parsed: \(error)"))
+		}
+	}
+
+	private init(data: Data) throws {
+		self.data = data
+
+		let reader = ByteReader(data: data)
+		let magic = try reader.uint32(at: 0, bigEndian: true)
+
+		switch magic {
+		case UInt32(FAT_MAGIC), UInt32(FAT_MAGIC_64):
+			let is64Bit = magic == UInt32(FAT_MAGIC_64)
+			let count = Int(try reader.uint32(at: 4, bigEndian: true))
+			let entrySize = is64Bit ? 32 : 20
+
+			slices = try (0..<count).map { index -> Slice in
+				let entryOffset = 8 + index * entrySize
+				let cpuType = cpu_type_t(bitPattern: try reader.uint32(at: entryOffset, bigEndian: true))
+				let cpuSubtype = cpu_subtype_t(bitPattern: try reader.uint32(at: entryOffset + 4, bigEndian: true))
+
+				let offset: Int
+				let size: Int
+				let alignment: UInt32
+				if is64Bit {
+					offset = Int(try reader.uint64(at: entryOffset + 8, bigEndian: true))
+					size = Int(try reader.uint64(at: entryOffset + 16, bigEndian: true))
+					alignment = try reader.uint32(at: entryOffset + 24, bigEndian: true)
+				} else {
+					offset = Int(try reader.uint32(at: entryOffset + 8, bigEndian: true))
+					size = Int(try reader.uint32(at: entryOffset + 12, bigEndian: true))
+					alignment = try reader.uint32(at: entryOffset + 16, bigEndian: true)
+				}
+
+				let range = try reader.checkedRange(offset, size)
+				return Slice(
+					cpuType: cpuType,
+					cpuSubtype: cpuSubtype,
+					range: range,
+					alignment: alignment,
+					objects: try machObjects(in: range, reader: reader)
+				)
+			}
+			isUniversal = true
+
+		default:
+			let range = 0..<data.count
+			let objects = try machObjects(in: range, reader: reader)
+			guard let header = objects.first?.header else {
+				throw MachOError("has no Mach-O objects")
+			}
+
+			slices = [
+				Slice(
+					cpuType: header.cpuType,
+					cpuSubtype: header.cpuSubtype,
+					range: range,
+					alignment: try defaultAlignment(of: objects, in: range, reader: reader),
+					objects: objects
+				),
+			]
+			isUniversal = false
+		}
+	}
+}
+
+extension MachOFile {
+	/// The SDK named by the last `LC_VERSION_MIN_<PLATFORM>` load command in
+	/// the file, if there is one.
+	var minimumVersionSDKName: String? {
+		let sdkNamesByCommand: [UInt32: String] = [
+			UInt32(LC_VERSION_MIN_MACOSX): "macosx",
+			UInt32(LC_VERSION_MIN_IPHONEOS): "iphoneos",
+			UInt32(LC_VERSION_MIN_WATCHOS): "watchos",
+			UInt32(LC_VERSION_MIN_TVOS): "tvos",
+		]
+
+		return slices
+			.flatMap { $0.objects }
+			.flatMap { $0.loadCommands }
+			.compactMap { sdkNamesByCommand[$0.command] }
+			.last
+	}
+
+	/// The UUIDs in the `LC_UUID` load commands of the file: usually one per
+	/// architecture, and none for static libraries.
+	var uuids: Set<UUID> {
+		let uuids = slices
+			.flatMap { $0.objects }
+			.flatMap { $0.loadCommands }
+			.filter { $0.command == UInt32(LC_UUID) && $0.range.count >= 24 }
+			.map { command -> UUID in
+				let uuidRange = (command.range.lowerBound + 8)..<(command.range.lowerBound + 24)
+				return data.subdata(in: uuidRange).withUnsafeBytes { (bytes: UnsafePointer<UInt8>) in
+					NSUUID(uuidBytes: bytes) as UUID
+				}
+			}
+
+		return Set(uuids)
+	}
+
+	/// Returns the contents of the file without the slices of the given
+	/// architectures, like `lipo -remove` does: a universal file of the other
+	/// slices, each at its original alignment.
+	///
+	/// If none of the architectures are in the file, returns its contents as
+	/// they are.
+	func removingArchitectures(_ architectures: Set<String>) -> Result<Data, MachOError> {
+		let keptSlices = slices.filter { !architectures.contains($0.architecture) }
+		guard keptSlices.count < slices.count else {
+			return .success(data)
+		}
+		guard isUniversal else {
+			return .failure(MachOError("is not a universal file, so its architecture can't be removed"))
+		}
+		guard !keptSlices.isEmpty else {
+			return .failure(MachOError("would have no architectures left"))
+		}
+
+		let is64Bit = (try? ByteReader(data: data).uint32(at: 0, bigEndian: true)) == UInt32(FAT_MAGIC_64)
+		return MachOFile.universalFileContents(of: keptSlices.map { (slice: $0, data: data) }, is64Bit: is64Bit)
+	}
+
+	/// Returns the contents of a universal file of the slices of the given
+	/// files, like `lipo -create` does.
+	///
+	/// Like `lipo`, slices are ordered by alignment, except that arm64 slices
+	/// come last, and the header is only 64-bit if the slices don't fit
+	/// otherwise.
+	static func merging(_ files: [MachOFile]) -> Result<Data, MachOError> {
+		let slices = files.flatMap { file in file.slices.map { (slice: $0, data: file.data) } }
+
+		var architectures = Set<String>()
+		for (slice, _) in slices {
+			guard architectures.insert(slice.architecture).inserted else {
+				return .failure(MachOError("have more than one slice for \(slice.architecture)"))
+			}
+		}
+
+		let arm64 = cpu_type_t(bitPattern: 0x0100_000c)
+		let sortedSlices = slices.enumerated()
+			.sorted { lhs, rhs in
+				let (left, right) = (lhs.element.slice, rhs.element.slice)
+				if left.cpuType == right.cpuType {
+					return (left.cpuSubtype & 0x00ff_ffff, lhs.offset) < (right.cpuSubtype & 0x00ff_ffff, rhs.offset)
+				}
+				if left.cpuType == arm64 || right.cpuType == arm64 {
+					return right.cpuType == arm64
+				}
+				return (left.alignment, lhs.offset) < (right.alignment, rhs.offset)
+			}
+			.map { $0.element }
+
+		let size = sortedSlices.reduce(8 + sortedSlices.count * 20) { size, slice in
+			size + (1 << Int(min(slice.slice.alignment, 15))) + slice.slice.range.count
+		}
+		return universalFileContents(of: sortedSlices, is64Bit: size > Int(UInt32.max))
+	}
+
+	/// Lays out the given slices, each taken from the contents of its file, in
+	/// a universal file.
+	private static func universalFileContents(of slices: [(slice: Slice, data: Data)], is64Bit: Bool) -> Result<Data, MachOError> {
+		guard slices.allSatisfy({ $0.slice.alignment <= 15 }) else {
+			return .failure(MachOError("has a slice with an unsupported alignment"))
+		}
+
+		var end = 8 + slices.count * (is64Bit ? 32 : 20)
+		let offsets = slices.map { slice -> Int in
+			let alignment = 1 << Int(slice.slice.alignment)
+			let offset = (end + alignment - 1) / alignment * alignment
+			end = offset + slice.slice.range.count
+			return offset
+		}
+		guard is64Bit || end <= Int(UInt32.max) else {
+			return .failure(MachOError("is too large for a 32-bit universal header"))
+		}
+
+		var output = Data(capacity: end)
+		func append(_ value: UInt32) {
+			output.append(contentsOf: [ 24, 16, 8, 0 ].map { UInt8(truncatingIfNeeded: value >> $0) })
+		}
+		func append(_ value: UInt64) {
+			append(UInt32(truncatingIfNeeded: value >> 32))
+			append(UInt32(truncatingIfNeeded: value))
+		}
+
+		append(is64Bit ? UInt32(FAT_MAGIC_64) : UInt32(FAT_MAGIC))
+		append(UInt32(slices.count))
+		for ((slice, _), offset) in zip(slices, offsets) {
+			append(UInt32(bitPattern: slice.cpuType))
+			append(UInt32(bitPattern: slice.cpuSubtype))
+			if is64Bit {
+				append(UInt64(offset))
+				append(UInt64(slice.range.count))
+				append(slice.alignment)
+				append(UInt32(0))
+			} else {
+				append(UInt32(offset))
+				append(UInt32(slice.range.count))
+				append(slice.alignment)
+			}
+		}
+
+		for ((slice, data), offset) in zip(slices, offsets) {
+			output.append(Data(count: offset - output.count))
+			output.append(data[slice.range])
+		}
+
+		return .success(output)
+	}
+}
+
+/// The prefix of static libraries.
+private let archiveMagic = Data("!<arch>\n".utf8)
+
+/// Parses the Mach-O object, or the objects of the static library, in the
+/// given range.
+private func machObjects(in range: Range<Int>, reader: ByteReader) throws -> [MachOFile.MachObject] {
+	if reader.data.count >= range.lowerBound + archiveMagic.count
+		&& reader.data[range.lowerBound..<(range.lowerBound + archiveMagic.count)] == archiveMagic {
+		return try archiveMemberRanges(in: range, reader: reader)
+			.filter { isMachObject(at: $0.lowerBound, reader: reader) }
+			.map { try machObject(in: $0, reader: reader) }
+	}
+
+	return [ try machObject(in: range, reader: reader) ]
+}
+
+/// Finds the contents of the members of the static library in the given
+/// range.
+private func archiveMemberRanges(in range: Range<Int>, reader: ByteReader) throws -> [Range<Int>] {
+	let headerSize = 60
+	var ranges: [Range<Int>] = []
+	var offset = range.lowerBound + archiveMagic.count
+
+	while offset + headerSize <= range.upperBound {
+		let name = try reader.string(at: offset, length: 16)
+		guard let size = Int(try reader.string(at: offset + 48, length: 10)) else {
+			throw MachOError("has a malformed static library member at offset \(offset)")
+		}
+
+		// BSD archives put long names right after the header.
+		var nameLength = 0
+		if name.hasPrefix("#1/"), let length = Int(name.dropFirst(3)) {
+			nameLength = length
+		}
+
+		let contentsOffset = offset + headerSize + nameLength
+		let contentsSize = size - nameLength
+		guard contentsSize >= 0, contentsOffset + contentsSize <= range.upperBound else {
+			throw MachOError("has a truncated static library member at offset \(offset)")
+		}
+		ranges.append(contentsOffset..<(contentsOffset + contentsSize))
+
+		// Members are aligned to 2 bytes.
+		offset = offset + headerSize + size
+		offset += offset % 2
+	}
+
+	return ranges
+}
+
+private func isMachObject(at offset: Int, reader: ByteReader) -> Bool {
+	guard let magic = try? reader.uint32(at: offset, bigEndian: false) else {
+		return false
+	}
+
+	return [ MH_MAGIC, MH_MAGIC_64, MH_CIGAM, MH_CIGAM_64 ].contains(magic)
+}
+
+/// Parses the header and load commands of the Mach-O object in the given
+/// range.
+private func machObject(in range: Range<Int>, reader: ByteReader) throws -> MachOFile.MachObject {
+	let offset = range.lowerBound
+	guard isMachObject(at: offset, reader: reader) else {
+		throw MachOError("is not a Mach-O file")
+	}
+
+	// The magic tells the byte order of the rest.
+	let magic = try reader.uint32(at: offset, bigEndian: false)
+	let bigEndian = magic == MH_CIGAM || magic == MH_CIGAM_64
+	let is64Bit = magic == MH_MAGIC_64 || magic == MH_CIGAM_64
+	let field = { (index: Int) in try reader.uint32(at: offset + index * 4, bigEndian: bigEndian) }
+	let reserved: UInt32? = try is64Bit ? field(7) : nil
+
+	let header = MachHeader(
+		magic: magic,
+		cpuType: cpu_type_t(bitPattern: try field(1)),
+		cpuSubtype: cpu_subtype_t(bitPattern: try field(2)),
+		fileType: try field(3),
+		ncmds: try field(4),
+		sizeofcmds: try field(5),
+		flags: try field(6),
+		reserved: reserved
+	)
+
+	var loadCommands: [MachOFile.LoadCommand] = []
+	var commandOffset = offset + (is64Bit ? 32 : 28)
+	for _ in 0..<header.ncmds {
+		let command = try reader.uint32(at: commandOffset, bigEndian: bigEndian)
+		let size = Int(try reader.uint32(at: commandOffset + 4, bigEndian: bigEndian))
+		guard size >= 8 else {
+			throw MachOError("has a malformed load command at offset \(commandOffset)")
+		}
+
+		let commandRange = try reader.checkedRange(commandOffset, size)
+		guard commandRange.upperBound <= range.upperBound else {
+			throw MachOError("has a truncated load command at offset \(commandOffset)")
+		}
+
+		loadCommands.append(MachOFile.LoadCommand(command: command, range: commandRange))
+		commandOffset += size
+	}
+
+	return MachOFile.MachObject(header: header, range: range, loadCommands: loadCommands)
+}
+
+/// The highest alignment `lipo` gives a slice, as a power of 2.
+private let maximumSectionAlignment: UInt32 = 15
+
+/// Guesses the alignment of a thin slice the way `lipo` does: static
+/// libraries are aligned to their word size, object files to their most
+/// aligned section, and everything else to the coarsest alignment all of its
+/// segments' addresses have, usually the page size.
+private func defaultAlignment(of objects: [MachOFile.MachObject], in range: Range<Int>, reader: ByteReader) throws -> UInt32 {
+	guard let object = objects.first, object.range == range else {
+		return objects.first?.header.is64BitHeader == true ? 3 : 2
+	}
+
+	let header = object.header
+	let bigEndian = header.endianess == .big
+	let segmentCommand = UInt32(header.is64BitHeader ? LC_SEGMENT_64 : LC_SEGMENT)
+	let segments = object.loadCommands.filter { $0.command == segmentCommand }
+
+	if header.fileType == UInt32(MH_OBJECT) {
+		// section(_64) follow segment_command(_64), and have their alignment
+		// 44 (or 52) bytes in.
+		let (segmentSize, sectionSize, alignmentOffset) = header.is64BitHeader ? (72, 80, 52) : (56, 68, 44)
+		var alignment: UInt32 = 0
+		for segment in segments {
+			let sectionCount = Int(try reader.uint32(at: segment.range.lowerBound + segmentSize - 8, bigEndian: bigEndian))
+			for index in 0..<sectionCount {
+				let sectionOffset = segment.range.lowerBound + segmentSize + index * sectionSize
+				alignment = max(alignment, try reader.uint32(at: sectionOffset + alignmentOffset, bigEndian: bigEndian))
+			}
+		}
+		return min(alignment, maximumSectionAlignment)
+	}
+
+	var alignment = maximumSectionAlignment
+	for segment in segments {
+		// The address follows the command, its size and the segment's name.
+		let address = try header.is64BitHeader
+			? reader.uint64(at: segment.range.lowerBound + 24, bigEndian: bigEndian)
+			: UInt64(reader.uint32(at: segment.range.lowerBound + 24, bigEndian: bigEndian))
+		guard address != 0 else {
+			continue
+		}
+
+		alignment = min(alignment, max(UInt32(address.trailingZeroBitCount), 2))
+	}
+	return alignment
+}
+
+/// Names the given architecture like `lipo` and `xcodebuild` do.
+internal func architectureName(cpuType: cpu_type_t, cpuSubtype: cpu_subtype_t) -> String {
+	// The capability bits of the subtype (like pointer authentication's
+	// version on arm64e) don't change the architecture.
+	let subtype = UInt32(bitPattern: cpuSubtype) & ~0xff00_0000
+
+	switch (UInt32(bitPattern: cpuType), subtype) {
+	case (7, _): return "i386"
+	case (0x0100_0007, 8): return "x86_64h"
+	case (0x0100_0007, _): return "x86_64"
+	case (12, 6): return "armv6"
+	case (12, 9): return "armv7"
+	case (12, 10): return "armv7f"
+	case (12, 11): return "armv7s"
+	case (12, 12): return "armv7k"
+	case (12, 13): return "armv8"
+	case (12, 14): return "armv6m"
+	case (12, 15): return "armv7m"
+	case (12, 16): return "armv7em"
+	case (12, _): return "arm"
+	case (0x0100_000c, 2): return "arm64e"
+	case (0x0100_000c, _): return "arm64"
+	case (0x0200_000c, _): return "arm64_32"
+	case (18, _): return "ppc"
+	case (0x0100_0012, _): return "ppc64"
+	default: return "cputype \(cpuType) cpusubtype \(subtype)"
+	}
+}
+
+/// Reads integers and strings from the contents of a file, failing instead
+/// of reading beyond them.
+internal struct ByteReader {
+	let data: Data
+
+	func checkedRange(_ offset: Int, _ length: Int) throws -> Range<Int> {
+		guard offset >= 0, length >= 0, offset <= data.count - length else {
+			throw MachOError("is truncated at offset \(offset)")
+		}
+		return offset..<(offset + length)
+	}
+
+	func uint32(at offset: Int, bigEndian: Bool) throws -> UInt32 {
+		let range = try checkedRange(offset, 4)
+		return data[range].reduce(into: UInt32(0)) { value, byte in
+			value = bigEndian ? value << 8 | UInt32(byte) : value >> 8 | UInt32(byte) << 24
+		}
+	}
+
+	func uint64(at offset: Int, bigEndian: Bool) throws -> UInt64 {
+		let high = UInt64(try uint32(at: bigEndian ? offset : offset + 4, bigEndian: bigEndian))
+		let low = UInt64(try uint32(at: bigEndian ? offset + 4 : offset, bigEndian: bigEndian))
+		return high << 32 | low
+	}
+
+	/// Reads an ASCII string padded with spaces or NULs.
+	func string(at offset: Int, length: Int) throws -> String {
+		let bytes = data[try checkedRange(offset, length)]
+		return String(decoding: bytes, as: UTF8.self)
+			.trimmingCharacters(in: CharacterSet.whitespaces.union(CharacterSet(charactersIn: "\0")))
+	}
+}
+
+/// Describes what's wrong with a file which couldn't be parsed.
+internal struct MachOError: Error, CustomStringConvertible {
+	let description: String
+
+	init(_ description: String) {
+		self.description = description
+	}
+}
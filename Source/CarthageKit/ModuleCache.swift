@@ -0,0 +1,145 @@
+import Foundation
+import ReactiveSwift
+import Result
+
+/// The Clang and Swift module caches shared by the builds of all
+/// dependencies, so that implicit modules like Foundation's are precompiled
+/// once per toolchain instead of once per dependency.
+///
+/// Each Xcode and toolchain gets a cache of its own, so that switching Xcodes
+/// starts from an empty cache, and the caches of Xcodes which aren't used
+/// anymore can be removed as a whole:
+///
+/// ~/Library/Caches/org.carthage.CarthageKit/ModuleCache/7d1a5e…/
+///
+/// Within a cache, the compilers coordinate concurrent builds with lock files,
+/// write modules atomically, rebuild modules whose headers changed and prune
+/// modules which haven't been used in a while. On top of that, builds hold a
+/// shared lock on the cache they use, and caches are only removed while
+/// holding an exclusive one, so that a cache never disappears from under a
+/// build.
+///
+/// The lock file of each cache lives next to it, as `7d1a5e….lock`, rather
+/// than within it, so that removing a cache doesn't remove the file that
+/// builds waiting to use it have already opened to lock.
+public struct ModuleCache {
+	/// Bumped whenever the layout of the caches changes.
+	private static let formatVersion = 2
+
+	/// The file URL of the file which builds using the cache at the given URL
+	/// lock, and whose modification date records when the cache was last
+	/// used.
+	static func lockFileURL(forCacheAt cacheURL: URL) -> URL {
+		return cacheURL.deletingLastPathComponent().appendingPathComponent("\(cacheURL.lastPathComponent).lock", isDirectory: false)
+	}
+
+	public let directoryURL: URL
+
+	public init(directoryURL: URL = Constants.Dependency.moduleCacheURL) {
+		self.directoryURL = directoryURL
+	}
+
+	/// The file URL of the cache for the given toolchain of the selected
+	/// Xcode, or nil if the Xcode can't be determined.
+	public func url(forToolchain toolchain: String?) -> URL? {
+		guard let xcodeFingerprint = BuildSettingsCache.xcodeFingerprint else {
+			return nil
+		}
+
+		let key = sha256HexDigest(of: [ "\(ModuleCache.formatVersion)", xcodeFingerprint, toolchain ?? "default" ].joined(separator: "\n"))
+		return directoryURL.appendingPathComponent(key, isDirectory: true)
+	}
+
+	/// Removes the caches which haven't been used for the given amount of
+	/// time, skipping those which are in use.
+	///
+	/// Sends the file URL of each cache once it has been removed.
+	public func removeCaches(unusedFor maximumAge: TimeInterval, now: Date = Date()) -> SignalProducer<URL, CarthageError> {
+		return SignalProducer { () -> Result<[URL], CarthageError> in
+				let contents = (try? FileManager.default.contentsOfDirectory(
+					at: self.directoryURL,
+					includingPropertiesForKeys: [ .isDirectoryKey ],
+					options: [ .skipsHiddenFiles ]
+				)) ?? []
+				return .success(contents.filter { (try? $0.resourceValues(forKeys: [ .isDirectoryKey ]))?.isDirectory == true })
+			}
+			.flatMap(.concat) { SignalProducer<URL, CarthageError>($0) }
+			.filterMap { cacheURL -> URL? in
+				let lockFileURL = ModuleCache.lockFileURL(forCacheAt: cacheURL)
+				let lastUsed = (try? lockFileURL.resourceValues(forKeys: [ .contentModificationDateKey ]))?.contentModificationDate
+				guard now.timeIntervalSince(lastUsed ?? .distantPast) > maximumAge else {
+					return nil
+				}
+
+				// Another build may have started using the cache since. The
+				// lock file itself is kept, as builds may be waiting on it.
+				guard let lock = FileLock(at: lockFileURL, exclusive: true, waiting: false) else {
+					return nil
+				}
+				defer { lock.unlock() }
+
+				return (try? FileManager.default.removeItem(at: cacheURL)) != nil ? cacheURL : nil
+			}
+	}
+}
+
+extension SignalProducer {
+	/// Holds a shared lock on the module cache at the given file URL, if
+	/// there is one, for as long as the producer runs, and marks it as used.
+	internal func usingModuleCache(at cacheURL: URL?) -> SignalProducer<Value, Error> {
+		guard let cacheURL = cacheURL else {
+			return self
+		}
+
+		return SignalProducer { observer, lifetime in
+			let lockFileURL = ModuleCache.lockFileURL(forCacheAt: cacheURL)
+			_ = try? FileManager.default.createDirectory(at: lockFileURL.deletingLastPathComponent(), withIntermediateDirectories: true)
+
+			if let lock = FileLock(at: lockFileURL, exclusive: false, waiting: true) {
+				_ = try? FileManager.default.setAttributes([ .modificationDate: Date() ], ofItemAtPath: lockFileURL.path)
+				lifetime += AnyDisposable { lock.unlock() }
+			}
+
+			// Only once the lock is held, as the cache may have been removed
+			// while waiting for it.
+			_ = try? FileManager.default.createDirectory(at: cacheURL, withIntermediateDirectories: true)
+
+			lifetime += self.start(observer)
+		}
+	}
+}
+
+/// An advisory lock on a file, which other processes see too.
+private final class FileLock {
+	private var fileDescriptor: Int32
+
+	/// Locks the file at the given URL, creating it if necessary. Unless
+	/// `waiting` is true, returns nil if the lock is held elsewhere.
+	init?(at fileURL: URL, exclusive: Bool, waiting: Bool) {
+		fileDescriptor = open(fileURL.path, O_RDONLY | O_CREAT | O_CLOEXEC, 0o644)
+		guard fileDescriptor >= 0 else {
+			return nil
+		}
+
+		let operation = (exclusive ? LOCK_EX : LOCK_SH) | (waiting ? 0 : LOCK_NB)
+		guard flock(fileDescriptor, operation) == 0 else {
+			close(fileDescriptor)
+			fileDescriptor = -1
+			return nil
+		}
+	}
+
+	deinit {
+		unlock()
+	}
+
+	func unlock() {
+		guard fileDescriptor >= 0 else {
+			return
+		}
+
+		flock(fileDescriptor, LOCK_UN)
+		close(fileDescriptor)
+		fileDescriptor = -1
+	}
+}
@@ -1,6 +1,7 @@
 import Dispatch
 import Foundation
 import ReactiveSwift
+import Result
 
 /// Manages the execution of SignalProducers, like the flatten(...) operator,
 /// but without all needing to be enqueued in the same context.
@@ -78,6 +79,12 @@ internal final class ConcurrentProducerQueue: ProducerQueue {
 	/// Creates a SignalProducer that will enqueue the given producer when 
 	/// started.
 	func enqueue<T, Error>(_ producer: SignalProducer<T, Error>) -> SignalProducer<T, Error> {
+		return enqueue(producer, priority: .normal)
+	}
+
+	/// Creates a SignalProducer that will enqueue the given producer when
+	/// started, ahead of any waiting producers with a lower priority.
+	func enqueue<T, Error>(_ producer: SignalProducer<T, Error>, priority: Operation.QueuePriority) -> SignalProducer<T, Error> {
 		return SignalProducer { observer, lifetime in
 			let operation = Operation { operation in
 				if lifetime.hasEnded {
@@ -98,6 +105,7 @@ internal final class ConcurrentProducerQueue: ProducerQueue {
 				}
 			}
 
+			operation.queuePriority = priority
 			self.operationQueue.addOperation(operation)
 		}
 	}
@@ -123,3 +131,41 @@ internal final class ConcurrentProducerQueue: ProducerQueue {
 		}
 	}
 }
+
+/// Creates a producer for each of the given nodes, starting it once the
+/// producers of all the nodes it depends on have completed, with at most
+/// `limit` of them executing concurrently, and merges their events.
+///
+/// Dependencies on nodes that are not in `nodes` are ignored, so the given
+/// nodes must not depend on each other in a cycle.
+internal func mergeInDependencyOrder<Node: Hashable, Value, Error>(
+	_ nodes: [Node],
+	dependencies: @escaping (Node) -> Set<Node>,
+	limit: Int,
+	_ transform: @escaping (Node) -> SignalProducer<Value, Error>
+) -> SignalProducer<Value, Error> {
+	// Set up the bookkeeping each time the producer is started.
+	return SignalProducer<(), Error>(value: ())
+		.flatMap(.merge) { _ -> SignalProducer<Value, Error> in
+			let queue = ConcurrentProducerQueue(name: "org.carthage.CarthageKit.mergeInDependencyOrder", limit: max(limit, 1))
+			let includedNodes = Set(nodes)
+
+			let completedNodes = Dictionary(uniqueKeysWithValues: nodes.map { ($0, MutableProperty(false)) })
+
+			let producers = nodes.map { node -> SignalProducer<Value, Error> in
+				let prerequisites = dependencies(node)
+					.intersection(includedNodes)
+					.map { completedNodes[$0]!.producer.filter { $0 }.take(first: 1) }
+
+				return SignalProducer<SignalProducer<Bool, NoError>, NoError>(prerequisites)
+					.flatten(.merge)
+					.promoteError(Error.self)
+					.then(queue.enqueue(transform(node)))
+					.on(completed: {
+						completedNodes[node]!.value = true
+					})
+			}
+
+			return SignalProducer<SignalProducer<Value, Error>, Error>(producers).flatten(.merge)
+		}
+}
@@ -46,8 +46,29 @@ public enum ProjectEvent {
 	/// Rebuilding a cached project because of a version file/framework mismatch.
 	case rebuildingCached(Dependency)
 
+	/// Building the project is being skipped because it is cached, and the
+	/// dependencies of it which have been rebuilt produced the same
+	/// frameworks as before.
+	case skippedBuildingUnchanged(Dependency)
+
 	/// Building an uncached project.
 	case buildingUncached(Dependency)
+
+	/// The build products of the project are being installed from the
+	/// artifact cache instead of being built.
+	case installingCachedArtifact(Dependency)
+
+	/// The build products of the project are being uploaded to the artifact
+	/// cache.
+	case uploadingArtifact(Dependency)
+
+	/// Uploading the build products of the project to the artifact cache
+	/// failed.
+	case skippedUploadingArtifact(Dependency, String)
+
+	/// The build products of the project are being installed from the local
+	/// build cache, because they have been built from the same inputs before.
+	case installingCachedBuild(Dependency)
 }
 
 extension ProjectEvent: Equatable {
@@ -106,11 +127,18 @@ public final class Project { // swiftlint:disable:this type_body_length
 	/// to download binary only frameworks.
 	public var useNetrc = false
 
+	/// Whether to hash binaries in the binaries cache again, even if they
+	/// haven't changed since they were last hashed.
+	public var rehashBinaries = false
+
 	/// Sends each event that occurs to a project underneath the receiver (or
 	/// the receiver itself).
 	public let projectEvents: Signal<ProjectEvent, NoError>
 	private let _projectEventsObserver: Signal<ProjectEvent, NoError>.Observer
 
+	/// Schedules and carries all network requests made for this project.
+	internal let transport = Transport()
+
 	public init(directoryURL: URL) {
 		precondition(directoryURL.isFileURL)
 
@@ -133,7 +161,12 @@ public final class Project { // swiftlint:disable:this type_body_length
 	private var cachedBinaryProjects: CachedBinaryProjects = [:]
 	private let cachedBinaryProjectsQueue = SerialProducerQueue(name: "org.carthage.Constants.Project.cachedBinaryProjectsQueue")
 
-	private lazy var xcodeVersionDirectory: String = XcodeVersion.make()
+	/// Indexes of the debug information in the directories that binaries have
+	/// been unarchived into, so that each directory is only indexed once per
+	/// run however many frameworks it contains.
+	private let debugSymbolsIndexes = Atomic<[URL: SignalProducer<DebugSymbolsIndex, CarthageError>]>([:])
+
+	private lazy var xcodeVersionDirectory: String = ToolchainCache.xcodeVersion
 		.map { "\($0.version)_\($0.buildVersion)" } ?? "Unknown"
 
 	/// Attempts to load Cartfile or Cartfile.private from the given directory,
@@ -240,7 +273,7 @@ public final class Project { // swiftlint:disable:this type_body_length
 					self._projectEventsObserver.send(value: .downloadingBinaryFrameworkDefinition(.binary(binary), binary.url))
 
 					let request = self.buildURLRequest(for: binary.url, useNetrc: self.useNetrc)
-					return URLSession.proxiedSession.reactive.data(with: request)
+					return self.transport.data(with: request)
 						.mapError { CarthageError.readFailed(binary.url, $0 as NSError) }
 						.attemptMap { data, _ in
 							return BinaryProject.from(jsonData: data).mapError { error in
@@ -575,10 +608,12 @@ public final class Project { // swiftlint:disable:this type_body_length
 	/// Updates the dependencies of the project to the latest version. The
 	/// changes will be reflected in Cartfile.resolved, and also in the working
 	/// directory checkouts if the given parameter is true.
+	///
+	/// If build options are given, binaries are downloaded while checking out.
 	public func updateDependencies(
 		shouldCheckout: Bool = true,
 		useNewResolver: Bool = false,
-		buildOptions: BuildOptions,
+		buildOptions: BuildOptions?,
 		dependenciesToUpdate: [String]? = nil
 	) -> SignalProducer<(), CarthageError> {
 		let resolverType: ResolverProtocol.Type
@@ -747,26 +782,14 @@ public final class Project { // swiftlint:disable:this type_body_length
 	private func installBinaries(for dependency: Dependency, pinnedVersion: PinnedVersion, preferXCFrameworks: Bool, toolchain: String?) -> SignalProducer<Bool, CarthageError> {
 		switch dependency {
 		case let .gitHub(server, repository):
-			let client = Client(server: server)
-			return self.downloadMatchingBinaries(
+			return self.matchingBinaries(
 				for: dependency,
 				pinnedVersion: pinnedVersion,
 				fromRepository: repository,
+				server: server,
 				preferXCFrameworks: preferXCFrameworks,
-				client: client
+				events: self._projectEventsObserver
 			)
-				.flatMapError { error -> SignalProducer<URL, CarthageError> in
-					if !client.isAuthenticated {
-						return SignalProducer(error: error)
-					}
-					return self.downloadMatchingBinaries(
-						for: dependency,
-						pinnedVersion: pinnedVersion,
-						fromRepository: repository,
-						preferXCFrameworks: preferXCFrameworks,
-						client: Client(server: server, isAuthenticated: false)
-					)
-				}
 				.flatMap(.concat) {
 					return self.unarchiveAndCopyBinaryFrameworks(zipFile: $0, projectName: dependency.name, pinnedVersion: pinnedVersion, toolchain: toolchain)
 				}
@@ -784,6 +807,103 @@ public final class Project { // swiftlint:disable:this type_body_length
 		}
 	}
 
+	/// Finds the binaries for the given dependency in the binaries cache, or
+	/// downloads them from its GitHub release.
+	///
+	/// Sends the URL to each zip in the binaries cache.
+	private func matchingBinaries(
+		for dependency: Dependency,
+		pinnedVersion: PinnedVersion,
+		fromRepository repository: Repository,
+		server: Server,
+		preferXCFrameworks: Bool,
+		events: Signal<ProjectEvent, NoError>.Observer
+	) -> SignalProducer<URL, CarthageError> {
+		return self.cachedMatchingBinaries(
+			for: dependency,
+			pinnedVersion: pinnedVersion,
+			fromRepository: repository,
+			server: server,
+			preferXCFrameworks: preferXCFrameworks,
+			events: events
+		)
+			.flatMap(.concat) { cachedURLs -> SignalProducer<URL, CarthageError> in
+				if let cachedURLs = cachedURLs {
+					return SignalProducer(cachedURLs)
+				}
+
+				let client = self.transport.client(for: server)
+				return self.downloadMatchingBinaries(
+					for: dependency,
+					pinnedVersion: pinnedVersion,
+					fromRepository: repository,
+					server: server,
+					preferXCFrameworks: preferXCFrameworks,
+					client: client,
+					events: events
+				)
+					.flatMapError { error -> SignalProducer<URL, CarthageError> in
+						if !client.isAuthenticated {
+							return SignalProducer(error: error)
+						}
+						return self.downloadMatchingBinaries(
+							for: dependency,
+							pinnedVersion: pinnedVersion,
+							fromRepository: repository,
+							server: server,
+							preferXCFrameworks: preferXCFrameworks,
+							client: self.transport.client(for: server, isAuthenticated: false),
+							events: events
+						)
+					}
+			}
+	}
+
+	/// Looks up the binaries for the given dependency in the release metadata
+	/// cache, without going through the GitHub API unless the cached release
+	/// has to be revalidated.
+	///
+	/// Sends the URLs of the already downloaded zips, an empty array if it is
+	/// known that there are no binaries to install, or nil if the release has
+	/// to be looked up again.
+	private func cachedMatchingBinaries(
+		for dependency: Dependency,
+		pinnedVersion: PinnedVersion,
+		fromRepository repository: Repository,
+		server: Server,
+		preferXCFrameworks: Bool,
+		events: Signal<ProjectEvent, NoError>.Observer
+	) -> SignalProducer<[URL]?, CarthageError> {
+		let tag = pinnedVersion.commitish
+		guard let entry = ReleaseCache.entry(for: repository, tag: tag, server: server) else {
+			return SignalProducer(value: nil)
+		}
+
+		return ReleaseCache.validated(entry, for: repository, tag: tag, server: server, transport: self.transport)
+			.promoteError(CarthageError.self)
+			.map { entry -> [URL]? in
+				guard let entry = entry else {
+					return nil
+				}
+				guard let release = entry.release, !release.isDraft, !release.assets.isEmpty else {
+					return []
+				}
+
+				let potentialFrameworkAssets = release.assets.filter { isBinaryFrameworkAsset(named: $0.name, contentType: $0.contentType) }
+				let fileURLs = binaryAssetFilter(prioritizing: potentialFrameworkAssets, preferXCFrameworks: preferXCFrameworks)
+					.map { fileURLToCachedBinary(dependency, tag: release.tag, assetID: $0.id, assetName: $0.name) }
+
+				// Any asset missing from the binaries cache has to be downloaded,
+				// which needs a `Release.Asset` from the API.
+				guard fileURLs.allSatisfy({ verifyCachedBinary(at: $0, expectedSHA256: nil, rehash: self.rehashBinaries) }) else {
+					return nil
+				}
+
+				events.send(value: .downloadingBinaries(dependency, release.nameWithFallback))
+				return fileURLs
+			}
+	}
+
 	/// Downloads any binaries and debug symbols that may be able to be used
 	/// instead of a repository checkout.
 	///
@@ -793,23 +913,30 @@ public final class Project { // swiftlint:disable:this type_body_length
 		for dependency: Dependency,
 		pinnedVersion: PinnedVersion,
 		fromRepository repository: Repository,
+		server: Server,
 		preferXCFrameworks: Bool,
-		client: Client
+		client: Client,
+		events: Signal<ProjectEvent, NoError>.Observer
 	) -> SignalProducer<URL, CarthageError> {
-		return client.execute(repository.release(forTag: pinnedVersion.commitish))
+		let tag = pinnedVersion.commitish
+		return self.transport.release(forTag: tag, in: repository, client: client)
 			.map { _, release in release }
+			.on(value: { release in
+				ReleaseCache.store(release, for: repository, tag: tag, server: server)
+			})
 			.filter { release in
 				return !release.isDraft && !release.assets.isEmpty
 			}
 			.flatMapError { error -> SignalProducer<Release, CarthageError> in
 				switch error {
 				case .doesNotExist:
+					ReleaseCache.store(nil, for: repository, tag: tag, server: server)
 					return .empty
 
 				case let .apiError(_, _, error):
 					// Log the GitHub API request failure, not to error out,
 					// because that should not be fatal error.
-					self._projectEventsObserver.send(value: .skippedDownloadingBinaries(dependency, error.message))
+					events.send(value: .skippedDownloadingBinaries(dependency, error.message))
 					return .empty
 
 				default:
@@ -817,24 +944,19 @@ public final class Project { // swiftlint:disable:this type_body_length
 				}
 			}
 			.on(value: { release in
-				self._projectEventsObserver.send(value: .downloadingBinaries(dependency, release.nameWithFallback))
+				events.send(value: .downloadingBinaries(dependency, release.nameWithFallback))
 			})
 			.flatMap(.concat) { release -> SignalProducer<URL, CarthageError> in
-				let potentialFrameworkAssets = release.assets.filter { asset in
-					let matchesContentType = Constants.Project.binaryAssetContentTypes.contains(asset.contentType)
-					let matchesName = asset.name.contains(Constants.Project.frameworkBinaryAssetPattern) || asset.name.contains(Constants.Project.xcframeworkBinaryAssetPattern)
-					return matchesContentType && matchesName
-				}
+				let potentialFrameworkAssets = release.assets.filter { isBinaryFrameworkAsset(named: $0.name, contentType: $0.contentType) }
 				return SignalProducer<Release.Asset, CarthageError>(binaryAssetFilter(prioritizing: potentialFrameworkAssets, preferXCFrameworks: preferXCFrameworks))
 					.flatMap(.concat) { asset -> SignalProducer<URL, CarthageError> in
-						let fileURL = fileURLToCachedBinary(dependency, release, asset)
+						let fileURL = fileURLToCachedBinary(dependency, tag: release.tag, assetID: "\(asset.id)", assetName: asset.name)
 
-						if FileManager.default.fileExists(atPath: fileURL.path) {
+						if verifyCachedBinary(at: fileURL, expectedSHA256: nil, rehash: self.rehashBinaries) {
 							return SignalProducer(value: fileURL)
 						} else {
-							return client.download(asset: asset)
-								.mapError(CarthageError.gitHubAPIRequestFailed)
-								.flatMap(.concat) { downloadURL in cacheDownloadedBinary(downloadURL, toURL: fileURL) }
+							return self.transport.hashingDownload(asset: asset, server: server, isAuthenticated: client.isAuthenticated)
+								.flatMap(.concat) { file in cacheDownloadedBinary(file, toURL: fileURL, expectedSHA256: nil) }
 						}
 					}
 			}
@@ -848,7 +970,7 @@ public final class Project { // swiftlint:disable:this type_body_length
 	/// Sends the URL of the dSYM after copying.
 	public func copyDSYMToBuildFolderForFramework(_ frameworkURL: URL, fromDirectoryURL directoryURL: URL) -> SignalProducer<URL, CarthageError> {
 		let destinationDirectoryURL = frameworkURL.deletingLastPathComponent()
-		return dSYMForFramework(frameworkURL, inDirectoryURL: directoryURL)
+		return dSYMForFramework(frameworkURL, in: debugSymbolsIndex(for: directoryURL))
 			.copyFileURLsIntoDirectory(destinationDirectoryURL)
 	}
 
@@ -862,10 +984,25 @@ public final class Project { // swiftlint:disable:this type_body_length
 	/// Sends the URLs of the bcsymbolmap files after copying.
 	public func copyBCSymbolMapsToBuildFolderForFramework(_ frameworkURL: URL, fromDirectoryURL directoryURL: URL) -> SignalProducer<URL, CarthageError> {
 		let destinationDirectoryURL = frameworkURL.deletingLastPathComponent()
-		return BCSymbolMapsForFramework(frameworkURL, inDirectoryURL: directoryURL)
+		return BCSymbolMapsForFramework(frameworkURL, in: debugSymbolsIndex(for: directoryURL))
 			.copyFileURLsIntoDirectory(destinationDirectoryURL)
 	}
 
+	/// Returns the index of the debug information within the given directory,
+	/// which is built the first time it's started and then replayed.
+	private func debugSymbolsIndex(for directoryURL: URL) -> SignalProducer<DebugSymbolsIndex, CarthageError> {
+		return debugSymbolsIndexes.modify { indexes in
+			let key = directoryURL.standardizedFileURL
+			if let index = indexes[key] {
+				return index
+			}
+
+			let index = DebugSymbolsIndex.make(directoryURL: directoryURL).replayLazily(upTo: 1)
+			indexes[key] = index
+			return index
+		}
+	}
+
 	/// Creates a .version file for all of the provided frameworks.
 	public func createVersionFilesForFrameworks(
 		_ frameworkURLs: [URL],
@@ -972,6 +1109,9 @@ public final class Project { // swiftlint:disable:this type_body_length
 
 	/// Checks out the dependencies listed in the project's Cartfile.resolved,
 	/// optionally they are limited by the given list of dependency names.
+	///
+	/// If build options allowing binaries are given, the binaries which may be
+	/// installed when building are downloaded concurrently with the checkouts.
 	public func checkoutResolvedDependencies(_ dependenciesToCheckout: [String]? = nil, buildOptions: BuildOptions?) -> SignalProducer<(), CarthageError> {
 		/// Determine whether the repository currently holds any submodules (if
 		/// it even is a repository).
@@ -996,7 +1136,7 @@ public final class Project { // swiftlint:disable:this type_body_length
 			}
 			.zip(with: submodulesSignal)
 			.flatMap(.merge) { dependencies, submodulesByPath -> SignalProducer<(), CarthageError> in
-				return SignalProducer<(Dependency, PinnedVersion), CarthageError>(dependencies)
+				let checkouts = SignalProducer<(Dependency, PinnedVersion), CarthageError>(dependencies)
 					.flatMap(.concurrent(limit: 4)) { dependency, version -> SignalProducer<(), CarthageError> in
 						switch dependency {
 						case .git, .gitHub:
@@ -1005,10 +1145,81 @@ public final class Project { // swiftlint:disable:this type_body_length
 							return .empty
 						}
 					}
+
+				guard let buildOptions = buildOptions, buildOptions.useBinaries else {
+					return checkouts
+				}
+
+				// Download binaries while checking out, so that the build finds
+				// them in the binaries cache instead of waiting on the network.
+				let prefetch = self.prefetchBinaries(for: dependencies, buildOptions: buildOptions)
+					.promoteError(CarthageError.self)
+				return SignalProducer.merge(checkouts, prefetch)
 			}
+			.on(terminated: {
+				// Checkouts may have changed project files that build settings
+				// were already looked up for.
+				BuildSettingsCache.invalidateFingerprints()
+			})
 			.then(SignalProducer<(), CarthageError>.empty)
 	}
 
+	/// Downloads the binaries that may be installed for the given dependencies
+	/// into the binaries cache, without installing them.
+	///
+	/// Dependencies whose version file shows that their build is already
+	/// cached are skipped, since building them will not install binaries.
+	///
+	/// Progress and failures are not reported, since installing the binaries
+	/// will do so.
+	private func prefetchBinaries(for dependencies: [(Dependency, PinnedVersion)], buildOptions: BuildOptions) -> SignalProducer<(), NoError> {
+		let events = Signal<ProjectEvent, NoError>.Observer()
+		let preferXCFrameworks = buildOptions.useXCFrameworks
+
+		return SignalProducer<(Dependency, PinnedVersion), NoError>(dependencies)
+			.flatMap(.merge) { dependency, version -> SignalProducer<(Dependency, PinnedVersion), NoError> in
+				guard buildOptions.cacheBuilds else {
+					return SignalProducer(value: (dependency, version))
+				}
+
+				return versionFileMatches(
+					dependency,
+					version: version,
+					platforms: buildOptions.platforms,
+					rootDirectoryURL: self.directoryURL,
+					toolchain: buildOptions.toolchain,
+					rehashBinaries: buildOptions.rehashBinaries
+				)
+					.flatMapError { _ in SignalProducer<Bool?, NoError>(value: nil) }
+					.filterMap { matches -> (Dependency, PinnedVersion)? in
+						return matches == true ? nil : (dependency, version)
+					}
+			}
+			.flatMap(.merge) { dependency, version -> SignalProducer<URL, NoError> in
+				let binaries: SignalProducer<URL, CarthageError>
+				switch dependency {
+				case let .gitHub(server, repository):
+					binaries = self.matchingBinaries(
+						for: dependency,
+						pinnedVersion: version,
+						fromRepository: repository,
+						server: server,
+						preferXCFrameworks: preferXCFrameworks,
+						events: events
+					)
+
+				case let .binary(binary):
+					binaries = self.binariesForBinaryProject(binary: binary, pinnedVersion: version, preferXCFrameworks: preferXCFrameworks, events: events)
+
+				case .git:
+					binaries = .empty
+				}
+
+				return binaries.flatMapError { _ in .empty }
+			}
+			.then(SignalProducer<(), NoError>.empty)
+	}
+
 	private func installBinariesForBinaryProject(
 		binary: BinaryURL,
 		pinnedVersion: PinnedVersion,
@@ -1016,6 +1227,26 @@ public final class Project { // swiftlint:disable:this type_body_length
 		toolchain: String?,
 		preferXCFrameworks: Bool
 	) -> SignalProducer<(), CarthageError> {
+		return self.binariesForBinaryProject(binary: binary, pinnedVersion: pinnedVersion, preferXCFrameworks: preferXCFrameworks, events: self._projectEventsObserver)
+			.flatMap(.concat) { zipFile in
+				self.unarchiveAndCopyBinaryFrameworks(zipFile: zipFile, projectName: projectName, pinnedVersion: pinnedVersion, toolchain: toolchain)
+ 					.on(failed: { _ in
+						try? FileManager.default.removeItem(at: zipFile)
+					})
+			}
+			.flatMap(.concat) { self.removeItem(at: $0) }
+	}
+
+	/// Finds the binaries for the given binary only framework in the binaries
+	/// cache, or downloads them.
+	///
+	/// Sends the URL to each zip in the binaries cache.
+	private func binariesForBinaryProject(
+		binary: BinaryURL,
+		pinnedVersion: PinnedVersion,
+		preferXCFrameworks: Bool,
+		events: Signal<ProjectEvent, NoError>.Observer
+	) -> SignalProducer<URL, CarthageError> {
 		return SignalProducer<SemanticVersion, ScannableError>(result: SemanticVersion.from(pinnedVersion))
 			.mapError { CarthageError(scannableError: $0) }
 			.combineLatest(with: self.downloadBinaryFrameworkDefinition(binary: binary))
@@ -1030,32 +1261,31 @@ public final class Project { // swiftlint:disable:this type_body_length
 				return SignalProducer(urlsAndVersions)
 			}
 			.flatMap(.concat) { semanticVersion, frameworkURL in
-				return self.downloadBinary(dependency: Dependency.binary(binary), version: semanticVersion, url: frameworkURL)
+				return self.downloadBinary(dependency: Dependency.binary(binary), version: semanticVersion, url: frameworkURL, events: events)
 			}
-			.flatMap(.concat) { zipFile in
-				self.unarchiveAndCopyBinaryFrameworks(zipFile: zipFile, projectName: projectName, pinnedVersion: pinnedVersion, toolchain: toolchain)
- 					.on(failed: { _ in
-						try? FileManager.default.removeItem(at: zipFile)
-					})
-			}
-			.flatMap(.concat) { self.removeItem(at: $0) }
 	}
 
 	/// Downloads the binary only framework file. Sends the URL to each downloaded zip, after it has been moved to a
 	/// less temporary location.
-	private func downloadBinary(dependency: Dependency, version: SemanticVersion, url: URL) -> SignalProducer<URL, CarthageError> {
+	private func downloadBinary(
+		dependency: Dependency,
+		version: SemanticVersion,
+		url: URL,
+		events: Signal<ProjectEvent, NoError>.Observer
+	) -> SignalProducer<URL, CarthageError> {
 		let fileURL = downloadURLToCachedBinaryDependency(dependency, version, url)
+		let expectedSHA256 = url.declaredSHA256
 
-		if FileManager.default.fileExists(atPath: fileURL.path) {
+		if verifyCachedBinary(at: fileURL, expectedSHA256: expectedSHA256, rehash: self.rehashBinaries) {
 			return SignalProducer(value: fileURL)
 		} else {
 			let request = self.buildURLRequest(for: url, useNetrc: self.useNetrc)
-			return URLSession.proxiedSession.reactive.download(with: request)
+			return self.transport.hashingDownload(with: request)
 				.on(started: {
-					self._projectEventsObserver.send(value: .downloadingBinaries(dependency, version.description))
+					events.send(value: .downloadingBinaries(dependency, version.description))
 				})
 				.mapError { CarthageError.readFailed(url, $0 as NSError) }
-				.flatMap(.concat) { downloadURL, _ in cacheDownloadedBinary(downloadURL, toURL: fileURL) }
+				.flatMap(.concat) { file, _ in cacheDownloadedBinary(file, toURL: fileURL, expectedSHA256: expectedSHA256) }
 		}
 	}
 
@@ -1143,49 +1373,87 @@ public final class Project { // swiftlint:disable:this type_body_length
 	/// Cached dependencies whose dependency trees are also cached will not
 	/// be rebuilt unless otherwise specified via build options.
 	///
+	/// A cached dependency which depends on rebuilt ones is only rebuilt once
+	/// those have been, if the frameworks or public interfaces of any of them
+	/// actually changed.
+	///
 	/// Returns a producer-of-producers representing each scheme being built.
 	public func buildCheckedOutDependenciesWithOptions( // swiftlint:disable:this cyclomatic_complexity function_body_length
 		_ options: BuildOptions,
 		dependenciesToBuild: [String]? = nil,
 		sdkFilter: @escaping SDKFilterCallback = { sdks, _, _, _ in .success(sdks) }
 	) -> BuildSchemeProducer {
+		// swiftlint:disable:next nesting
+		typealias DependencyGraph = [Dependency: Set<Dependency>]
+
+		var options = options
+		let moduleCacheURL = options.useSharedModuleCache ? ModuleCache().url(forToolchain: options.toolchain) : nil
+		options.moduleCachePath = moduleCacheURL?.path
+
 		return loadResolvedCartfile()
 			.flatMap(.concat) { resolvedCartfile -> SignalProducer<(Dependency, PinnedVersion), CarthageError> in
 				return self.buildOrderForResolvedCartfile(resolvedCartfile, dependenciesToInclude: dependenciesToBuild)
 			}
 			.flatMap(.concat) { dependency, version -> SignalProducer<((Dependency, PinnedVersion), Set<Dependency>, Bool?), CarthageError> in
+				let matches = self.buildInputs(of: dependency, version: version, withOptions: options)
+					.flatMap(.concat) { buildInputs in
+						versionFileMatches(
+							dependency,
+							version: version,
+							platforms: options.platforms,
+							rootDirectoryURL: self.directoryURL,
+							toolchain: options.toolchain,
+							buildInputs: buildInputs,
+							rehashBinaries: options.rehashBinaries
+						)
+					}
+
 				return SignalProducer.combineLatest(
 					SignalProducer(value: (dependency, version)),
 					self.dependencySet(for: dependency, version: version),
-					versionFileMatches(dependency, version: version, platforms: options.platforms, rootDirectoryURL: self.directoryURL, toolchain: options.toolchain)
+					matches
 				)
 			}
-			.reduce([]) { includedDependencies, nextGroup -> [(Dependency, PinnedVersion)] in
+			.reduce(([], [:], [])) { state, nextGroup -> ([(Dependency, PinnedVersion)], DependencyGraph, Set<Dependency>) in
+				let (includedDependencies, graph, cachedDependencies) = state
 				let (nextDependency, projects, matches) = nextGroup
 
+				var graphIncludingNext = graph
+				graphIncludingNext[nextDependency.0] = projects
+
 				var dependenciesIncludingNext = includedDependencies
 				dependenciesIncludingNext.append(nextDependency)
 
 				let projectsToBeBuilt = Set(includedDependencies.map { $0.0 })
 
-				guard options.cacheBuilds && projects.isDisjoint(with: projectsToBeBuilt) else {
-					return dependenciesIncludingNext
+				guard options.cacheBuilds else {
+					return (dependenciesIncludingNext, graphIncludingNext, cachedDependencies)
+				}
+
+				guard projects.isDisjoint(with: projectsToBeBuilt) else {
+					// Whether a cached dependency has to be rebuilt against the
+					// dependencies being built before it is only known once
+					// they have been.
+					let cachedDependenciesIncludingNext = matches == true
+						? cachedDependencies.union([ nextDependency.0 ])
+						: cachedDependencies
+					return (dependenciesIncludingNext, graphIncludingNext, cachedDependenciesIncludingNext)
 				}
 
 				guard let versionFileMatches = matches else {
 					self._projectEventsObserver.send(value: .buildingUncached(nextDependency.0))
-					return dependenciesIncludingNext
+					return (dependenciesIncludingNext, graphIncludingNext, cachedDependencies)
 				}
 
 				if versionFileMatches {
 					self._projectEventsObserver.send(value: .skippedBuildingCached(nextDependency.0))
-					return includedDependencies
+					return (includedDependencies, graphIncludingNext, cachedDependencies)
 				} else {
 					self._projectEventsObserver.send(value: .rebuildingCached(nextDependency.0))
-					return dependenciesIncludingNext
+					return (dependenciesIncludingNext, graphIncludingNext, cachedDependencies)
 				}
 			}
-			.flatMap(.concat) { (dependencies: [(Dependency, PinnedVersion)]) -> SignalProducer<(Dependency, PinnedVersion), CarthageError> in
+			.flatMap(.concat) { dependencies, graph, cachedDependencies -> SignalProducer<([(Dependency, PinnedVersion)], DependencyGraph, Set<Dependency>), CarthageError> in
 				return SignalProducer(dependencies)
 					.flatMap(.concurrent(limit: 4)) { dependency, version -> SignalProducer<(Dependency, PinnedVersion), CarthageError> in
 						switch dependency {
@@ -1209,53 +1477,320 @@ public final class Project { // swiftlint:disable:this type_body_length
 							.then(.init(value: (dependency, version)))
 					}
 					.collect()
-					.map { installedDependencies -> [(Dependency, PinnedVersion)] in
+					.map { installedDependencies -> ([(Dependency, PinnedVersion)], DependencyGraph, Set<Dependency>) in
 						// Filters out dependencies that we've downloaded binaries for
 						// but preserves the build order
-						return dependencies.filter { dependency -> Bool in
+						let dependenciesToBuild = dependencies.filter { dependency -> Bool in
 							!installedDependencies.contains { $0 == dependency }
 						}
+
+						// Binaries aren't compared with what they replaced, so
+						// anything depending on them is rebuilt.
+						let installed = Set(installedDependencies.map { $0.0 })
+						let cachedDependenciesToCheck = cachedDependencies.filter { dependency in
+							transitiveIncomingNodes(graph, node: dependency).isDisjoint(with: installed)
+						}
+
+						return (dependenciesToBuild, graph, cachedDependenciesToCheck)
 					}
-					.flatten()
 			}
-			.flatMap(.concat) { dependency, version -> BuildSchemeProducer in
-				let dependencyPath = self.directoryURL.appendingPathComponent(dependency.relativePath, isDirectory: true).path
-				if !FileManager.default.fileExists(atPath: dependencyPath) {
+			.flatMap(.concat) { dependencies, graph, cachedDependencies -> BuildSchemeProducer in
+				// Build each dependency as soon as everything it depends on
+				// (even through dependencies which aren't being built) has been
+				// built, instead of one at a time in the build order.
+				let versions = Dictionary(uniqueKeysWithValues: dependencies)
+
+				// The dependencies whose frameworks changed by being built.
+				let changedDependencies = Atomic(Set<Dependency>())
+
+				return mergeInDependencyOrder(
+					dependencies.map { $0.0 },
+					dependencies: { transitiveIncomingNodes(graph, node: $0) },
+					limit: options.jobs
+				) { dependency in
+					// Decided once everything it depends on has been built.
+					return SignalProducer<(), CarthageError>(value: ())
+						.flatMap(.concat) { _ -> BuildSchemeProducer in
+							if cachedDependencies.contains(dependency)
+								&& transitiveIncomingNodes(graph, node: dependency).isDisjoint(with: changedDependencies.value) {
+								self._projectEventsObserver.send(value: .skippedBuildingUnchanged(dependency))
+								return .empty
+							}
+
+							let previousFingerprint = self.productFingerprint(of: dependency)
+							return self.buildDependency(dependency, version: versions[dependency]!, withOptions: options, sdkFilter: sdkFilter)
+								.on(completed: {
+									if self.productFingerprint(of: dependency) != previousFingerprint {
+										changedDependencies.modify { _ = $0.insert(dependency) }
+									}
+								})
+						}
+				}
+			}
+			.usingModuleCache(at: moduleCacheURL)
+	}
+
+	/// Digests the frameworks of the given dependency as recorded in its
+	/// version file, or returns nil if there is none.
+	private func productFingerprint(of dependency: Dependency) -> String? {
+		let versionFileURL = VersionFile.url(for: dependency, rootDirectoryURL: self.directoryURL)
+		let binariesDirectoryURL = self.directoryURL
+			.appendingPathComponent(Constants.binariesFolderPath, isDirectory: true)
+			.resolvingSymlinksInPath()
+
+		return VersionFile(url: versionFileURL)?.productFingerprint(binariesDirectoryURL: binariesDirectoryURL)
+	}
+
+	/// Builds the given checked out dependency, or installs it from the local
+	/// build cache or the artifact cache if one is configured.
+	private func buildDependency(
+		_ dependency: Dependency,
+		version: PinnedVersion,
+		withOptions options: BuildOptions,
+		sdkFilter: @escaping SDKFilterCallback
+	) -> BuildSchemeProducer {
+		let dependencyPath = self.directoryURL.appendingPathComponent(dependency.relativePath, isDirectory: true).path
+		if !FileManager.default.fileExists(atPath: dependencyPath) {
+			return .empty
+		}
+
+		var options = options
+		let derivedData = DerivedDataStore(directoryURL: options.derivedDataPath.map { URL(fileURLWithPath: $0, isDirectory: true) } ?? Constants.Dependency.derivedDataURL)
+		let derivedDataVersioned = derivedData.derivedDataURL(xcodeVersion: self.xcodeVersionDirectory, dependencyName: dependency.name, commitish: version.commitish)
+		options.derivedDataPath = derivedDataVersioned.resolvingSymlinksInPath().path
+
+		// Record the use before building too, so that the derived data isn't
+		// pruned from under the build.
+		let recordDerivedDataUse = { (measuringSize: Bool) in
+			_ = derivedData.recordUse(of: derivedDataVersioned, measuringSize: measuringSize)
+		}
+
+		let buildProducer = self.symlinkBuildPathIfNeeded(for: dependency, version: version)
+			.timed(.symlink, in: options.timeline, dependency: dependency.name)
+			.then(build(dependency: dependency, version: version, self.directoryURL, withOptions: options, sdkFilter: sdkFilter))
+			.on(
+				started: { recordDerivedDataUse(false) },
+				terminated: { recordDerivedDataUse(true) }
+			)
+			.flatMapError { error -> BuildSchemeProducer in
+				switch error {
+				case .noSharedFrameworkSchemes:
+					// Log that building the dependency is being skipped,
+					// not to error out with `.noSharedFrameworkSchemes`
+					// to continue building other dependencies.
+					self._projectEventsObserver.send(value: .skippedBuilding(dependency, error.description))
+
+					if options.cacheBuilds {
+						// Create a version file for a dependency with no shared schemes
+						// so that its cache is not always considered invalid.
+						return createVersionFileForCommitish(version.commitish,
+															 dependencyName: dependency.name,
+															 platforms: options.platforms,
+															 buildProducts: [],
+															 rootDirectoryURL: self.directoryURL)
+							.then(BuildSchemeProducer.empty)
+					}
 					return .empty
+
+				default:
+					return SignalProducer(error: error)
 				}
+			}
 
-				var options = options
-				let baseURL = options.derivedDataPath.flatMap(URL.init(string:)) ?? Constants.Dependency.derivedDataURL
-				let derivedDataPerXcode = baseURL.appendingPathComponent(self.xcodeVersionDirectory, isDirectory: true)
-				let derivedDataPerDependency = derivedDataPerXcode.appendingPathComponent(dependency.name, isDirectory: true)
-				let derivedDataVersioned = derivedDataPerDependency.appendingPathComponent(version.commitish, isDirectory: true)
-				options.derivedDataPath = derivedDataVersioned.resolvingSymlinksInPath().path
-
-				return self.symlinkBuildPathIfNeeded(for: dependency, version: version)
-					.then(build(dependency: dependency, version: version, self.directoryURL, withOptions: options, sdkFilter: sdkFilter))
-					.flatMapError { error -> BuildSchemeProducer in
-						switch error {
-						case .noSharedFrameworkSchemes:
-							// Log that building the dependency is being skipped,
-							// not to error out with `.noSharedFrameworkSchemes`
-							// to continue building other dependencies.
-							self._projectEventsObserver.send(value: .skippedBuilding(dependency, error.description))
-
-							if options.cacheBuilds {
-								// Create a version file for a dependency with no shared schemes
-								// so that its cache is not always considered invalid.
-								return createVersionFileForCommitish(version.commitish,
-																	 dependencyName: dependency.name,
-																	 platforms: options.platforms,
-																	 buildProducts: [],
-																	 rootDirectoryURL: self.directoryURL)
-									.then(BuildSchemeProducer.empty)
-							}
-							return .empty
+		let installOrBuildProducer: BuildSchemeProducer
+		if let location = options.artifactCacheURL {
+			switch artifactCache(at: location, transport: self.transport) {
+			case let .success(cache):
+				installOrBuildProducer = self.installFromArtifactCache(dependency, version: version, withOptions: options, cache: cache, orElse: buildProducer)
 
-						default:
-							return SignalProducer(error: error)
+			case let .failure(error):
+				return BuildSchemeProducer(error: error)
+			}
+		} else {
+			installOrBuildProducer = buildProducer
+		}
+
+		return self.buildInputs(of: dependency, version: version, withOptions: options)
+			.flatMap(.concat) { buildInputs -> BuildSchemeProducer in
+				guard let buildInputs = buildInputs else {
+					return installOrBuildProducer
+				}
+
+				return self.installFromBuildCache(
+					dependency,
+					version: version,
+					buildInputs: buildInputs,
+					withOptions: options,
+					orElse: installOrBuildProducer
+				)
+			}
+	}
+
+	/// Sends the digest of the inputs of building the given dependency with
+	/// the products of its dependencies as they are now, or nil if its build
+	/// isn't cached by its inputs.
+	private func buildInputs(
+		of dependency: Dependency,
+		version: PinnedVersion,
+		withOptions options: BuildOptions
+	) -> SignalProducer<String?, CarthageError> {
+		guard options.cacheBuilds else {
+			return SignalProducer(value: nil)
+		}
+		if case .binary = dependency {
+			return SignalProducer(value: nil)
+		}
+
+		return self.dependencySet(for: dependency, version: version)
+			.take(first: 1)
+			.flatMap(.concat) { dependencies in
+				BuildInputs.digest(
+					for: dependency,
+					dependencies: dependencies,
+					repositoryURL: repositoryFileURL(for: dependency),
+					rootDirectoryURL: self.directoryURL,
+					options: options
+				)
+				.promoteError(CarthageError.self)
+			}
+	}
+
+	/// Installs the build products of the given dependency from the local
+	/// build cache if they have been built from the same inputs before, or
+	/// otherwise runs the given build and adds its products to the cache.
+	///
+	/// Either way, the inputs are recorded in the version file of the
+	/// dependency, so that changes to them invalidate it.
+	private func installFromBuildCache(
+		_ dependency: Dependency,
+		version: PinnedVersion,
+		buildInputs: String,
+		withOptions options: BuildOptions,
+		orElse buildProducer: BuildSchemeProducer
+	) -> BuildSchemeProducer {
+		let buildCache = LocalBuildCache(rehashBinaries: options.rehashBinaries)
+		let versionFileURL = VersionFile.url(for: dependency, rootDirectoryURL: self.directoryURL)
+		let recordBuildInputs = SignalProducer<(), CarthageError> { () -> Result<(), CarthageError> in
+			guard let versionFile = VersionFile(url: versionFileURL) else {
+				return .success(())
+			}
+			return versionFile.recordingBuildInputs(buildInputs).write(to: versionFileURL)
+		}
+
+		let installCachedBuild = SignalProducer<URL?, CarthageError> { () -> Result<URL?, CarthageError> in
+				return .success(buildCache.archiveURL(forInputs: buildInputs))
+			}
+			.flatMap(.concat) { archiveURL -> SignalProducer<Bool, CarthageError> in
+				guard let archiveURL = archiveURL else {
+					return SignalProducer(value: false)
+				}
+
+				self._projectEventsObserver.send(value: .installingCachedBuild(dependency))
+				return self.unarchiveAndCopyBinaryFrameworks(zipFile: archiveURL, projectName: dependency.name, pinnedVersion: version, toolchain: options.toolchain)
+					.flatMap(.concat) { self.removeItem(at: $0) }
+					.then(self.symlinkBuildPathIfNeeded(for: dependency, version: version))
+					.then(SignalProducer<Bool, CarthageError>(value: true))
+					.flatMapError { _ in SignalProducer(value: false) }
+			}
+
+		return installCachedBuild.flatMap(.concat) { installed -> BuildSchemeProducer in
+			if installed {
+				return recordBuildInputs.then(BuildSchemeProducer.empty)
+			}
+
+			let storeBuildProducts = self.archiveBuildProducts(of: dependency) { archiveURL in
+					SignalProducer(result: buildCache.store(archiveURL, forInputs: buildInputs))
+				}
+				// The cache is an optimization, so failing to add to it doesn't
+				// fail the build.
+				.flatMapError { _ in SignalProducer<(), CarthageError>.empty }
+
+			return buildProducer
+				.concat(recordBuildInputs.then(storeBuildProducts).then(BuildSchemeProducer.empty))
+		}
+	}
+
+	/// Installs the build products of the given dependency from the artifact
+	/// cache if they are there, or otherwise runs the given build and uploads
+	/// its products to the cache.
+	private func installFromArtifactCache(
+		_ dependency: Dependency,
+		version: PinnedVersion,
+		withOptions options: BuildOptions,
+		cache artifactCache: ArtifactCache,
+		orElse buildProducer: BuildSchemeProducer
+	) -> BuildSchemeProducer {
+		return ArtifactCacheKey.make(for: dependency, version: version, options: options)
+			.flatMap(.concat) { key -> BuildSchemeProducer in
+				let installCachedArtifact = artifactCache.fetch(key)
+					// The cache is an optimization, so failing to reach it is
+					// treated like a miss.
+					.flatMapError { _ in SignalProducer(value: nil) }
+					.flatMap(.concat) { zipFile -> SignalProducer<Bool, CarthageError> in
+						guard let zipFile = zipFile else {
+							return SignalProducer(value: false)
 						}
+
+						self._projectEventsObserver.send(value: .installingCachedArtifact(dependency))
+						return self.unarchiveAndCopyBinaryFrameworks(zipFile: zipFile, projectName: dependency.name, pinnedVersion: version, toolchain: options.toolchain)
+							.flatMap(.concat) { self.removeItem(at: $0) }
+							.then(self.symlinkBuildPathIfNeeded(for: dependency, version: version))
+							.then(SignalProducer<Bool, CarthageError>(value: true))
+							.on(terminated: {
+								try? FileManager.default.removeItem(at: zipFile)
+							})
+							.flatMapError { _ in SignalProducer(value: false) }
+					}
+
+				return installCachedArtifact.flatMap(.concat) { installed -> BuildSchemeProducer in
+					if installed {
+						return .empty
+					}
+
+					return buildProducer
+						.concat(self.uploadArtifact(of: dependency, for: key, to: artifactCache).then(BuildSchemeProducer.empty))
+				}
+			}
+	}
+
+	/// Zips the build products of the given dependency, as recorded in its
+	/// version file, and uploads them to the artifact cache.
+	///
+	/// Failures are reported without failing the build.
+	private func uploadArtifact(of dependency: Dependency, for key: ArtifactCacheKey, to artifactCache: ArtifactCache) -> SignalProducer<(), CarthageError> {
+		return archiveBuildProducts(of: dependency) { archiveURL in
+				self._projectEventsObserver.send(value: .uploadingArtifact(dependency))
+				return artifactCache.store(archiveURL, for: key)
+			}
+			.flatMapError { error in
+				self._projectEventsObserver.send(value: .skippedUploadingArtifact(dependency, error.description))
+				return .empty
+			}
+	}
+
+	/// Zips the build products of the given dependency, as recorded in its
+	/// version file, into a temporary directory and runs the given action on
+	/// the archive before removing it again.
+	///
+	/// Does nothing if the dependency has no build products.
+	private func archiveBuildProducts(
+		of dependency: Dependency,
+		_ action: @escaping (URL) -> SignalProducer<(), CarthageError>
+	) -> SignalProducer<(), CarthageError> {
+		return artifactPaths(for: dependency, rootDirectoryURL: self.directoryURL)
+			.flatMap(.concat) { paths -> SignalProducer<(), CarthageError> in
+				guard !paths.isEmpty else {
+					return .empty
+				}
+
+				return FileManager.default.reactive.createTemporaryDirectoryWithTemplate("carthage-artifact.XXXXXX")
+					.flatMap(.concat) { directoryURL -> SignalProducer<(), CarthageError> in
+						let archiveURL = directoryURL.appendingPathComponent("\(dependency.name).zip", isDirectory: false)
+						return zip(paths: paths, into: archiveURL, workingDirectory: self.directoryURL.path)
+							.then(action(archiveURL))
+							.on(terminated: {
+								try? FileManager.default.removeItem(at: directoryURL)
+							})
 					}
 			}
 	}
@@ -1333,9 +1868,17 @@ private func symlinkBuildPath(for dependency: Dependency, rootDirectoryURL: URL)
 
 /// Constructs a file URL to where the binary corresponding to the given
 /// arguments should live.
-private func fileURLToCachedBinary(_ dependency: Dependency, _ release: Release, _ asset: Release.Asset) -> URL {
+private func fileURLToCachedBinary(_ dependency: Dependency, tag: String, assetID: String, assetName: String) -> URL {
 	// ~/Library/Caches/org.carthage.CarthageKit/binaries/ReactiveCocoa/v2.3.1/1234-ReactiveCocoa.framework.zip
-	return Constants.Dependency.assetsURL.appendingPathComponent("\(dependency.name)/\(release.tag)/\(asset.id)-\(asset.name)", isDirectory: false)
+	return Constants.Dependency.assetsURL.appendingPathComponent("\(dependency.name)/\(tag)/\(assetID)-\(assetName)", isDirectory: false)
+}
+
+/// Whether a release asset with the given name and content type looks like a
+/// zipped framework or xcframework.
+private func isBinaryFrameworkAsset(named name: String, contentType: String) -> Bool {
+	let matchesContentType = Constants.Project.binaryAssetContentTypes.contains(contentType)
+	let matchesName = name.contains(Constants.Project.frameworkBinaryAssetPattern) || name.contains(Constants.Project.xcframeworkBinaryAssetPattern)
+	return matchesContentType && matchesName
 }
 
 /// Constructs a file URL to where the binary only framework download should be cached
@@ -1356,11 +1899,15 @@ private func downloadURLToCachedBinaryDependency(_ dependency: Dependency, _ sem
 		.appendingPathComponent("\(dependency.name)/\(semanticVersion)/\(fileName)-\(hexDigest).\(fileExtension)")
 }
 
-/// Caches the downloaded binary at the given URL, moving it to the other URL
-/// given.
+/// Caches the given downloaded binary, moving it to the URL given, and
+/// records the digest computed while downloading it so that it can be
+/// verified when it is reused.
+///
+/// Fails if an expected SHA-256 digest is given and the binary doesn't match it.
 ///
 /// Sends the final file URL upon .success.
-private func cacheDownloadedBinary(_ downloadURL: URL, toURL cachedURL: URL) -> SignalProducer<URL, CarthageError> {
+private func cacheDownloadedBinary(_ file: DownloadedFile, toURL cachedURL: URL, expectedSHA256: String?) -> SignalProducer<URL, CarthageError> {
+	let downloadURL = file.url
 	return SignalProducer(value: cachedURL)
 		.attempt { fileURL in
 			Result(at: fileURL.deletingLastPathComponent(), attempt: {
@@ -1391,6 +1938,9 @@ private func cacheDownloadedBinary(_ downloadURL: URL, toURL cachedURL: URL) ->
 				try FileManager.default.moveItem(at: downloadURL, to: $0)
 			})
 		}
+		.attempt { fileURL in
+			recordCachedBinaryDigest(at: fileURL, expectedSHA256: expectedSHA256, sha256: file.sha256)
+		}
 }
 
 /// Sends the URL to each file found in the given directory conforming to the
@@ -1430,30 +1980,7 @@ func platformForFramework(_ frameworkURL: URL) -> SignalProducer<SDK, CarthageEr
 					return nil
 				}
 
-				let task = Task("/usr/bin/xcrun", arguments: ["otool", "-lv", executableURL.path])
-
-				let sdkName: String? = task.launch(standardInput: nil)
-					.ignoreTaskData()
-					.map { String(data: $0, encoding: .utf8) ?? "" }
-					.filter { !$0.isEmpty }
-					.flatMap(.merge) { (output: String) -> SignalProducer<String, NoError> in
-						output.linesProducer
-					}
-					.filter { $0.contains("LC_VERSION") }
-					.take(last: 1)
-					.map { lcVersionLine -> String? in
-						let sdkString = lcVersionLine.split(separator: "_")
-							.last
-							.flatMap(String.init)
-							.flatMap { $0.lowercased() }
-
-						return sdkString
-					}
-					.skipNil()
-					.single()?
-					.value
-
-				return sdkName
+				return MachOFile.read(at: executableURL).value?.minimumVersionSDKName
 			}
 
 			// Try to read what platfrom this binary is for. Attempt in order:
@@ -1517,20 +2044,54 @@ internal func dSYMsInDirectory(_ directoryURL: URL) -> SignalProducer<URL, Carth
 	return filesInDirectory(directoryURL, "com.apple.xcode.dsym")
 }
 
+/// The dSYMs and bcsymbolmap files within a directory, by the UUIDs they have
+/// debug information for.
+///
+/// Indexing a directory reads each dSYM once, so that matching the frameworks
+/// of the directory to their debug information is a lookup instead of a scan
+/// of the directory per framework.
+internal struct DebugSymbolsIndex {
+	var dSYMURLsByUUID: [UUID: URL] = [:]
+	var BCSymbolMapURLsByUUID: [UUID: URL] = [:]
+
+	/// Indexes the dSYMs and bcsymbolmap files found in the given directory,
+	/// or errors if there was an error parsing a dSYM.
+	///
+	/// Where several files have debug information for the same UUID, the
+	/// first one found wins.
+	static func make(directoryURL: URL) -> SignalProducer<DebugSymbolsIndex, CarthageError> {
+		let dSYMs = dSYMsInDirectory(directoryURL)
+			.flatMap(.merge) { dSYMURL in
+				return UUIDsForDSYM(dSYMURL).map { uuids in (uuids, dSYMURL) }
+			}
+			.reduce(into: [UUID: URL]()) { dSYMURLsByUUID, dSYM in
+				for uuid in dSYM.0 where dSYMURLsByUUID[uuid] == nil {
+					dSYMURLsByUUID[uuid] = dSYM.1
+				}
+			}
+
+		let BCSymbolMaps = BCSymbolMapsInDirectory(directoryURL)
+			.reduce(into: [UUID: URL]()) { BCSymbolMapURLsByUUID, fileURL in
+				let basename = fileURL.deletingPathExtension().lastPathComponent
+				if let uuid = UUID(uuidString: basename), BCSymbolMapURLsByUUID[uuid] == nil {
+					BCSymbolMapURLsByUUID[uuid] = fileURL
+				}
+			}
+
+		return SignalProducer.zip(dSYMs, BCSymbolMaps)
+			.map { DebugSymbolsIndex(dSYMURLsByUUID: $0, BCSymbolMapURLsByUUID: $1) }
+	}
+}
+
 /// Sends the URL of the dSYM for which at least one of the UUIDs are common with
 /// those of the given framework, or errors if there was an error parsing a dSYM
 /// contained within the directory.
-private func dSYMForFramework(_ frameworkURL: URL, inDirectoryURL directoryURL: URL) -> SignalProducer<URL, CarthageError> {
+private func dSYMForFramework(_ frameworkURL: URL, in index: SignalProducer<DebugSymbolsIndex, CarthageError>) -> SignalProducer<URL, CarthageError> {
 	return UUIDsForFramework(frameworkURL)
-		.flatMap(.concat) { (frameworkUUIDs: Set<UUID>) in
-			return dSYMsInDirectory(directoryURL)
-				.flatMap(.merge) { dSYMURL in
-					return UUIDsForDSYM(dSYMURL)
-						.filter { (dSYMUUIDs: Set<UUID>) in
-							return !dSYMUUIDs.isDisjoint(with: frameworkUUIDs)
-						}
-						.map { _ in dSYMURL }
-				}
+		.flatMap(.concat) { frameworkUUIDs in
+			return index.filterMap { index in
+				frameworkUUIDs.lazy.compactMap { index.dSYMURLsByUUID[$0] }.first
+			}
 		}
 		.take(first: 1)
 }
@@ -1542,29 +2103,13 @@ internal func BCSymbolMapsInDirectory(_ directoryURL: URL) -> SignalProducer<URL
 }
 
 /// Sends the URLs of the bcsymbolmap files that match the given framework and are
-/// located somewhere within the given directory.
-private func BCSymbolMapsForFramework(_ frameworkURL: URL, inDirectoryURL directoryURL: URL) -> SignalProducer<URL, CarthageError> {
+/// indexed.
+private func BCSymbolMapsForFramework(_ frameworkURL: URL, in index: SignalProducer<DebugSymbolsIndex, CarthageError>) -> SignalProducer<URL, CarthageError> {
 	return UUIDsForFramework(frameworkURL)
-		.flatMap(.merge) { uuids -> SignalProducer<URL, CarthageError> in
-			if uuids.isEmpty {
-				return .empty
+		.flatMap(.merge) { uuids in
+			return index.flatMap(.merge) { index in
+				SignalProducer(uuids.compactMap { index.BCSymbolMapURLsByUUID[$0] })
 			}
-			func filterUUIDs(_ signal: Signal<URL, CarthageError>) -> Signal<URL, CarthageError> {
-				var remainingUUIDs = uuids
-				let count = remainingUUIDs.count
-				return signal
-					.filter { fileURL in
-						let basename = fileURL.deletingPathExtension().lastPathComponent
-						if let fileUUID = UUID(uuidString: basename) {
-							return remainingUUIDs.remove(fileUUID) != nil
-						} else {
-							return false
-						}
-					}
-					.take(first: count)
-			}
-			return BCSymbolMapsInDirectory(directoryURL)
-				.lift(filterUUIDs)
 		}
 }
 
@@ -1704,3 +2249,5 @@ extension URL: AssetNameConvertible {
 	var name: String { return lastPathComponent }
 }
 extension Release.Asset: AssetNameConvertible {}
+
+extension CachedRelease.Asset: AssetNameConvertible {}
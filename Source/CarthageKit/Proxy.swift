@@ -75,10 +75,15 @@ extension Proxy {
 }
 
 extension URLSession {
-    public static var proxiedSession: URLSession {
+    /// A session honoring the proxy settings from the environment.
+    ///
+    /// The session is shared, so that connections (and HTTP/2 streams) to a
+    /// host are reused across requests instead of being set up anew for each
+    /// of them.
+    public static let proxiedSession: URLSession = {
         let configuration = URLSessionConfiguration.default
         configuration.connectionProxyDictionary = Proxy.default.connectionProxyDictionary
 
         return URLSession(configuration: configuration)
-    }
+    }()
 }
@@ -0,0 +1,204 @@
+import Foundation
+import Result
+import ReactiveSwift
+import Tentacle
+
+/// The parts of a GitHub release needed to locate its binary assets, as
+/// recorded in the release metadata cache.
+internal struct CachedRelease: Codable, Equatable {
+	/// An asset of a cached release.
+	internal struct Asset: Codable, Hashable {
+		/// The identifier of the asset, as rendered from `Release.Asset.id`.
+		let id: String
+		let name: String
+		let contentType: String
+	}
+
+	let tag: String
+	let name: String?
+	let isDraft: Bool
+	let assets: [Asset]
+
+	/// The name of this release, with fallback to its tag when the name is an empty string or nil.
+	var nameWithFallback: String {
+		if let name = name, !name.isEmpty {
+			return name
+		}
+		return tag
+	}
+}
+
+extension CachedRelease {
+	init(_ release: Release) {
+		self.init(
+			tag: release.tag,
+			name: release.name,
+			isDraft: release.isDraft,
+			assets: release.assets.map { asset in
+				Asset(id: "\(asset.id)", name: asset.name, contentType: asset.contentType)
+			}
+		)
+	}
+}
+
+/// An entry of the release metadata cache.
+///
+/// An entry without a release records that no release exists for the tag.
+internal struct ReleaseCacheEntry: Codable {
+	/// The release, or nil if the tag has no release.
+	let release: CachedRelease?
+
+	/// The `ETag` returned the last time the entry was revalidated, if any.
+	let etag: String?
+
+	/// When the entry was last fetched or revalidated.
+	let date: Date
+
+	/// Whether the entry can be used without asking GitHub again.
+	var isFresh: Bool {
+		let interval = release == nil ? ReleaseCache.negativeResultTimeToLive : ReleaseCache.revalidationInterval
+		return (0...interval).contains(Date().timeIntervalSince(date))
+	}
+}
+
+/// Persists release→asset-list lookups of GitHub dependencies between runs,
+/// so that binaries already in the binaries cache can be installed without a
+/// full GitHub API request each time.
+internal struct ReleaseCache {
+	/// Amount of time a cached release is trusted before it is revalidated
+	/// with a conditional request. Defaults to 1 hour.
+	static var revalidationInterval: TimeInterval = 60 * 60
+
+	/// Amount of time a "no release for this tag" result is cached. Defaults
+	/// to 1 hour.
+	static var negativeResultTimeToLive: TimeInterval = 60 * 60
+
+	/// Formats dates for `If-Modified-Since` headers.
+	private static let httpDateFormatter: DateFormatter = {
+		let formatter = DateFormatter()
+		formatter.locale = Locale(identifier: "en_US_POSIX")
+		formatter.timeZone = TimeZone(identifier: "GMT")
+		formatter.dateFormat = "EEE, dd MMM yyyy HH:mm:ss zzz"
+		return formatter
+	}()
+
+	/// Constructs the file URL of the cache entry for the given tag.
+	///
+	/// ~/Library/Caches/org.carthage.CarthageKit/releases/github.com/ReactiveCocoa/ReactiveSwift/v2.3.1.json
+	static func fileURL(
+		for repository: Repository,
+		tag: String,
+		server: Server,
+		directoryURL: URL = Constants.Dependency.releasesURL
+	) -> URL {
+		var allowedCharacters = CharacterSet.alphanumerics
+		allowedCharacters.insert(charactersIn: "-_.+")
+		let escapedTag = tag.addingPercentEncoding(withAllowedCharacters: allowedCharacters) ?? tag
+
+		return directoryURL
+			.appendingPathComponent(server.url.host ?? "\(server)", isDirectory: true)
+			.appendingPathComponent(repository.owner, isDirectory: true)
+			.appendingPathComponent(repository.name, isDirectory: true)
+			.appendingPathComponent(escapedTag, isDirectory: false)
+			.appendingPathExtension("json")
+	}
+
+	/// Reads the cache entry for the given tag, if there is one, and marks it
+	/// as used.
+	static func entry(
+		for repository: Repository,
+		tag: String,
+		server: Server,
+		directoryURL: URL = Constants.Dependency.releasesURL
+	) -> ReleaseCacheEntry? {
+		let url = fileURL(for: repository, tag: tag, server: server, directoryURL: directoryURL)
+		guard let data = CacheDirectory.contents(ofEntryAt: url) else {
+			return nil
+		}
+
+		return try? JSONDecoder().decode(ReleaseCacheEntry.self, from: data)
+	}
+
+	/// Writes the cache entry for the given tag.
+	@discardableResult
+	static func store(
+		_ entry: ReleaseCacheEntry,
+		for repository: Repository,
+		tag: String,
+		server: Server,
+		directoryURL: URL = Constants.Dependency.releasesURL
+	) -> Result<(), CarthageError> {
+		return Result(at: fileURL(for: repository, tag: tag, server: server, directoryURL: directoryURL), attempt: {
+			let data = try JSONEncoder().encode(entry)
+			try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+
+	/// Records the result of a release lookup, where a nil release means that
+	/// the tag has no release.
+	@discardableResult
+	static func store(
+		_ release: Release?,
+		for repository: Repository,
+		tag: String,
+		server: Server,
+		directoryURL: URL = Constants.Dependency.releasesURL
+	) -> Result<(), CarthageError> {
+		let entry = ReleaseCacheEntry(release: release.map(CachedRelease.init), etag: nil, date: Date())
+		return store(entry, for: repository, tag: tag, server: server, directoryURL: directoryURL)
+	}
+
+	/// Sends the given entry if it is fresh, or revalidates it with a
+	/// conditional request against the GitHub API.
+	///
+	/// Sends the refreshed entry if GitHub confirms it is unchanged, or nil if
+	/// the release has to be looked up again.
+	static func validated(
+		_ entry: ReleaseCacheEntry,
+		for repository: Repository,
+		tag: String,
+		server: Server,
+		transport: Transport,
+		directoryURL: URL = Constants.Dependency.releasesURL
+	) -> SignalProducer<ReleaseCacheEntry?, NoError> {
+		if entry.isFresh {
+			return SignalProducer(value: entry)
+		}
+
+		// Expired negative results are simply looked up again.
+		guard entry.release != nil else {
+			return SignalProducer(value: nil)
+		}
+
+		let url = server.apiURL
+			.appendingPathComponent("repos/\(repository.owner)/\(repository.name)/releases/tags")
+			.appendingPathComponent(tag)
+
+		var request = URLRequest(url: url)
+		request.setValue("application/vnd.github.v3+json", forHTTPHeaderField: "Accept")
+		request.setValue(gitHubUserAgent(), forHTTPHeaderField: "User-Agent")
+		request.setValue(httpDateFormatter.string(from: entry.date), forHTTPHeaderField: "If-Modified-Since")
+		if let etag = entry.etag {
+			request.setValue(etag, forHTTPHeaderField: "If-None-Match")
+		}
+		if let authorization = gitHubAuthorizationHeader(forServer: server) {
+			request.setValue(authorization, forHTTPHeaderField: "Authorization")
+		}
+
+		return transport.data(with: request)
+			.map { _, response -> ReleaseCacheEntry? in
+				guard let response = response as? HTTPURLResponse, response.statusCode == 304 else {
+					return nil
+				}
+
+				let etag = response.allHeaderFields
+					.first { ($0.key as? String)?.lowercased() == "etag" }
+					.flatMap { $0.value as? String } ?? entry.etag
+				let revalidated = ReleaseCacheEntry(release: entry.release, etag: etag, date: Date())
+				store(revalidated, for: repository, tag: tag, server: server, directoryURL: directoryURL)
+				return revalidated
+			}
+			.flatMapError { _ in SignalProducer(value: nil) }
+	}
+}
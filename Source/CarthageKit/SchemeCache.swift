@@ -0,0 +1,104 @@
+import Foundation
+import Result
+import XCDBLD
+
+/// A buildable scheme and the project or workspace to build it from, as
+/// persisted by `SchemeCache`.
+internal struct CachedScheme: Codable, Equatable {
+	let scheme: String
+	let projectPath: String
+	let isWorkspace: Bool
+
+	init(scheme: Scheme, project: ProjectLocator) {
+		self.scheme = scheme.name
+		self.projectPath = project.fileURL.path
+		if case .workspace = project {
+			self.isWorkspace = true
+		} else {
+			self.isWorkspace = false
+		}
+	}
+
+	var pair: (Scheme, ProjectLocator) {
+		let url = URL(fileURLWithPath: projectPath, isDirectory: true)
+		return (Scheme(scheme), isWorkspace ? .workspace(url) : .projectFile(url))
+	}
+}
+
+/// Persists the buildable schemes found in each directory between runs, so
+/// that discovering them again in an unchanged checkout doesn't have to ask
+/// `xcodebuild` for schemes and their build settings.
+///
+/// Entries are keyed by the directory, the configuration and platforms the
+/// schemes are built for, the selected Xcode, the contents of the project,
+/// workspace, scheme and configuration files in the directory, and what
+/// `xcodebuild` inherits from the environment, as for `BuildSettingsCache`.
+internal struct SchemeCache {
+	/// Bumped whenever the format of keys or entries changes.
+	private static let formatVersion = 2
+
+	/// Constructs the file URL of the cache entry with the given key.
+	///
+	/// ~/Library/Caches/org.carthage.CarthageKit/Schemes/7d1a5e….json
+	static func fileURL(forKey key: String, directoryURL: URL = Constants.Dependency.schemesURL) -> URL {
+		return directoryURL.appendingPathComponent("\(key).json", isDirectory: false)
+	}
+
+	/// Computes the key for the buildable schemes in the given directory, as
+	/// discovered by `xcodebuild` with the given environment, or nil if they
+	/// shouldn't be cached.
+	static func key(
+		for directoryURL: URL,
+		configuration: String,
+		platforms: Set<SDK>?,
+		environment: [String: String] = ProcessInfo.processInfo.environment
+	) -> String? {
+		guard
+			let xcodeFingerprint = BuildSettingsCache.xcodeFingerprint,
+			let projectFingerprint = BuildSettingsCache.fingerprint(ofProjectFilesIn: directoryURL),
+			let environmentFingerprint = BuildSettingsCache.inheritedXCConfigFingerprint(environment: environment)
+		else {
+			return nil
+		}
+
+		let platformNames = platforms.map { $0.map { $0.rawValue }.sorted().joined(separator: ",") } ?? "all"
+		let components = [
+			"\(formatVersion)",
+			xcodeFingerprint,
+			projectFingerprint,
+			environmentFingerprint,
+			directoryURL.resolvingSymlinksInPath().path,
+			configuration,
+			platformNames,
+		]
+
+		return sha256HexDigest(of: components.joined(separator: "\n"))
+	}
+
+	/// Reads the schemes cached for the given key, if there are any, and
+	/// marks them as used.
+	static func schemes(forKey key: String, directoryURL: URL = Constants.Dependency.schemesURL) -> [(Scheme, ProjectLocator)]? {
+		guard
+			let data = CacheDirectory.contents(ofEntryAt: fileURL(forKey: key, directoryURL: directoryURL)),
+			let schemes = try? JSONDecoder().decode([CachedScheme].self, from: data)
+		else {
+			return nil
+		}
+
+		return schemes.map { $0.pair }
+	}
+
+	/// Writes the schemes for the given key.
+	@discardableResult
+	static func store(
+		_ schemes: [(Scheme, ProjectLocator)],
+		forKey key: String,
+		directoryURL: URL = Constants.Dependency.schemesURL
+	) -> Result<(), CarthageError> {
+		return Result(at: fileURL(forKey: key, directoryURL: directoryURL), attempt: {
+			let data = try JSONEncoder().encode(schemes.map { CachedScheme(scheme: $0.0, project: $0.1) })
+			try FileManager.default.createDirectory(at: $0.deletingLastPathComponent(), withIntermediateDirectories: true)
+			try data.write(to: $0, options: .atomic)
+		})
+	}
+}
@@ -0,0 +1,140 @@
+import Foundation
+import ReactiveSwift
+import ReactiveTask
+import Result
+import XCDBLD
+
+/// Persists the output of queries about the selected Xcode and toolchains,
+/// like `xcodebuild -version`, `xcodebuild -showsdks -json` and
+/// `swift --version`, between runs, so that every `carthage` process doesn't
+/// have to launch them again.
+///
+/// Entries are keyed by the exact invocation and a fingerprint of the
+/// toolchain: the resolved developer directory, and the inode, size and
+/// modification date of the files that change whenever Xcode, its platforms
+/// or the toolchains are updated. Without a developer directory to
+/// fingerprint, nothing is cached.
+internal struct ToolchainCache {
+	/// Bumped whenever the format of keys or entries changes.
+	private static let formatVersion = 1
+
+	/// The version of the selected Xcode, queried at most once per run.
+	static let xcodeVersion: XcodeVersion? = output(of: XcodeVersion.versionTask)
+		.single()?
+		.value
+		.flatMap { String(data: $0, encoding: .utf8) }
+		.flatMap(XcodeVersion.init(xcodebuildOutput:))
+
+	/// Sends the standard output of the given task, launching it only if it
+	/// hasn't been cached for the selected toolchain.
+	///
+	/// Output is only cached if the task succeeds.
+	static func output(
+		of task: Task,
+		toolchain: String? = nil,
+		developerDirectoryURL: URL? = ToolchainCache.developerDirectoryURL(),
+		directoryURL: URL = Constants.Dependency.toolchainsURL
+	) -> SignalProducer<Data, TaskError> {
+		let launch = task.launch(standardInput: nil).ignoreTaskData()
+		guard let key = key(for: task, toolchain: toolchain, developerDirectoryURL: developerDirectoryURL) else {
+			return launch
+		}
+
+		let fileURL = directoryURL.appendingPathComponent("\(key).txt", isDirectory: false)
+		return SignalProducer { () -> Result<Data?, TaskError> in .success(CacheDirectory.contents(ofEntryAt: fileURL)) }
+			.flatMap(.concat) { cachedOutput -> SignalProducer<Data, TaskError> in
+				if let cachedOutput = cachedOutput {
+					return SignalProducer(value: cachedOutput)
+				}
+
+				return launch.on(value: { output in
+					_ = try? FileManager.default.createDirectory(at: directoryURL, withIntermediateDirectories: true)
+					_ = try? output.write(to: fileURL, options: .atomic)
+				})
+			}
+	}
+
+	/// Computes the key for the output of the given task when run with the
+	/// given toolchain, or nil if its output shouldn't be cached.
+	static func key(for task: Task, toolchain: String?, developerDirectoryURL: URL?) -> String? {
+		guard
+			let developerDirectoryURL = developerDirectoryURL,
+			let toolchainFingerprint = fingerprint(developerDirectoryURL: developerDirectoryURL, toolchain: toolchain)
+		else {
+			return nil
+		}
+
+		let environment = (task.environment ?? [:])
+			.sorted { $0.key < $1.key }
+			.map { "\($0.key)=\($0.value)" }
+		let components = [ "\(formatVersion)", toolchainFingerprint, task.launchPath ]
+			+ task.arguments
+			+ environment
+
+		return sha256HexDigest(of: components.joined(separator: "\n"))
+	}
+
+	/// Identifies the Xcode in the given developer directory and the given
+	/// toolchain, or returns nil if the directory doesn't contain an Xcode.
+	static func fingerprint(developerDirectoryURL: URL, toolchain: String?) -> String? {
+		let xcodebuildURL = developerDirectoryURL.appendingPathComponent("usr/bin/xcodebuild", isDirectory: false)
+		guard let xcodebuildStatus = fileStatus(of: xcodebuildURL) else {
+			return nil
+		}
+
+		var lines = [
+			developerDirectoryURL.path,
+			xcodebuildStatus,
+			fileStatus(of: developerDirectoryURL.deletingLastPathComponent().appendingPathComponent("Info.plist")) ?? "-",
+			fileStatus(of: developerDirectoryURL.appendingPathComponent("Toolchains/XcodeDefault.xctoolchain/usr/bin/swift")) ?? "-",
+			fileStatus(of: developerDirectoryURL.appendingPathComponent("Platforms", isDirectory: true)) ?? "-",
+		]
+
+		// Other toolchains are selected by identifier, and are installed, or
+		// replaced, in these directories.
+		let environment = ProcessInfo.processInfo.environment
+		if let toolchain = toolchain ?? environment["TOOLCHAINS"] {
+			let toolchainsPath = "Library/Developer/Toolchains"
+			let homeToolchainsURL = URL(fileURLWithPath: NSHomeDirectory(), isDirectory: true).appendingPathComponent(toolchainsPath, isDirectory: true)
+			lines += [
+				toolchain,
+				fileStatus(of: URL(fileURLWithPath: "/" + toolchainsPath, isDirectory: true)) ?? "-",
+				fileStatus(of: homeToolchainsURL) ?? "-",
+			]
+		}
+
+		return sha256HexDigest(of: lines.joined(separator: "\n"))
+	}
+
+	/// Finds the developer directory that `xcrun` uses, without launching
+	/// `xcode-select`.
+	static func developerDirectoryURL() -> URL? {
+		let path: String
+		if let developerDirectory = ProcessInfo.processInfo.environment["DEVELOPER_DIR"], !developerDirectory.isEmpty {
+			path = developerDirectory
+		} else if let selectedDirectory = try? FileManager.default.destinationOfSymbolicLink(atPath: "/var/db/xcode_select_link") {
+			// Where `xcode-select --switch` records its selection.
+			path = selectedDirectory
+		} else {
+			return nil
+		}
+
+		// Like `xcrun`, accept the path of Xcode itself.
+		let url = URL(fileURLWithPath: path, isDirectory: true).resolvingSymlinksInPath()
+		let bundledDeveloperURL = url.appendingPathComponent("Contents/Developer", isDirectory: true)
+		return FileManager.default.fileExists(atPath: bundledDeveloperURL.path) ? bundledDeveloperURL : url
+	}
+
+	/// Describes the identity and last modification of the file at the given
+	/// URL, or returns nil if there is no file.
+	private static func fileStatus(of url: URL) -> String? {
+		guard let attributes = try? FileManager.default.attributesOfItem(atPath: url.resolvingSymlinksInPath().path) else {
+			return nil
+		}
+
+		let fileNumber = (attributes[.systemFileNumber] as? NSNumber)?.uint64Value ?? 0
+		let size = (attributes[.size] as? NSNumber)?.uint64Value ?? 0
+		let modificationDate = (attributes[.modificationDate] as? Date)?.timeIntervalSince1970 ?? 0
+		return "\(url.lastPathComponent) \(fileNumber) \(size) \(modificationDate)"
+	}
+}
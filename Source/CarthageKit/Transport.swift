@@ -0,0 +1,344 @@
+import Foundation
+import Result
+import ReactiveSwift
+import Tentacle
+
+/// The relative urgency of a request scheduled on a `Transport`.
+internal enum TransferPriority {
+	/// Small requests that other work is waiting on, like release lookups and
+	/// binary project definitions.
+	case high
+
+	/// Downloads of binaries that are about to be installed.
+	case normal
+
+	/// Downloads that may turn out to be unnecessary.
+	case low
+
+	fileprivate var queuePriority: Operation.QueuePriority {
+		switch self {
+		case .high:
+			return .high
+
+		case .normal:
+			return .normal
+
+		case .low:
+			return .low
+		}
+	}
+}
+
+/// The network layer shared by all requests made on behalf of a `Project`.
+///
+/// All requests go through one URL session, so that connections to a host are
+/// pooled, except for downloads hashed while they're written, which share a
+/// second one. All of them go through one scheduler, which bounds the number
+/// of transfers in flight, starts urgent ones first and backs off when a
+/// server reports being overloaded (HTTP 429 or 5xx).
+internal final class Transport {
+	/// The maximum number of requests in flight at once. Defaults to 8.
+	static var maximumConcurrentTransfers = 8
+
+	/// The number of times a request is retried when the server reports being
+	/// overloaded. Defaults to 3.
+	static var maximumRetries = 3
+
+	/// The delay before the first retry of a request, doubled for each
+	/// subsequent retry. Defaults to 1 second.
+	static var initialBackoffInterval: TimeInterval = 1
+
+	/// The session all requests are made with.
+	let session: URLSession
+
+	/// A session with the configuration of `session`, whose responses are
+	/// streamed to disk by `streamingDelegate`.
+	private let streamingSession: URLSession
+	private let streamingDelegate: StreamingDownloadDelegate
+
+	private let queue: ConcurrentProducerQueue
+
+	/// GitHub API clients by server and authentication, so that credentials are
+	/// only looked up once per server.
+	private var clients: [String: Client] = [:]
+	private let clientsLock = NSLock()
+
+	init(session: URLSession = .proxiedSession, maximumConcurrentTransfers: Int = Transport.maximumConcurrentTransfers) {
+		let streamingDelegate = StreamingDownloadDelegate()
+		self.session = session
+		self.streamingDelegate = streamingDelegate
+		self.streamingSession = URLSession(configuration: session.configuration, delegate: streamingDelegate, delegateQueue: nil)
+		self.queue = ConcurrentProducerQueue(name: "org.carthage.CarthageKit.Transport", limit: maximumConcurrentTransfers)
+	}
+
+	deinit {
+		// A session keeps its delegate alive until it's invalidated.
+		streamingSession.finishTasksAndInvalidate()
+	}
+
+	/// Returns the GitHub API client to use for the given server, creating it
+	/// on first use.
+	func client(for server: Server, isAuthenticated: Bool = true) -> Client {
+		let key = "\(server)|\(isAuthenticated)"
+
+		clientsLock.lock()
+		defer { clientsLock.unlock() }
+
+		if let client = clients[key] {
+			return client
+		}
+
+		let client = Client(server: server, isAuthenticated: isAuthenticated, urlSession: session)
+		clients[key] = client
+		return client
+	}
+
+	/// Enqueues the given request producer on the scheduler, retrying it with
+	/// exponential back-off while it fails with a retryable error.
+	///
+	/// Each attempt is enqueued on its own, so that a request waiting to be
+	/// retried doesn't hold a slot other requests could use.
+	func schedule<T, Error>(
+		_ producer: SignalProducer<T, Error>,
+		priority: TransferPriority,
+		retryingWhere shouldRetry: @escaping (Error) -> Bool
+	) -> SignalProducer<T, Error> {
+		return producer
+			.startOnQueue(queue, priority: priority.queuePriority)
+			.retry(upTo: Transport.maximumRetries, backingOffFrom: Transport.initialBackoffInterval, where: shouldRetry)
+	}
+
+	/// Loads the data for the given request.
+	///
+	/// As with `URLSession`, server side errors are not sent as errors, unless
+	/// the server was still overloaded after all retries.
+	func data(with request: URLRequest, priority: TransferPriority = .high) -> SignalProducer<(Data, URLResponse), AnyError> {
+		return schedule(
+			session.reactive.data(with: request).attemptMap(Transport.failIfOverloaded),
+			priority: priority,
+			retryingWhere: Transport.isOverloaded
+		)
+	}
+
+	/// Downloads the given request to a temporary file.
+	///
+	/// As with `URLSession`, server side errors are not sent as errors, unless
+	/// the server was still overloaded after all retries.
+	func download(with request: URLRequest, priority: TransferPriority = .normal) -> SignalProducer<(URL, URLResponse), AnyError> {
+		return schedule(
+			session.reactive.download(with: request).attemptMap(Transport.failIfOverloaded),
+			priority: priority,
+			retryingWhere: Transport.isOverloaded
+		)
+	}
+
+	/// Downloads the given request to a temporary file, computing the SHA-256
+	/// digest of its contents while they are written, so that the file
+	/// doesn't have to be read again to be verified.
+	///
+	/// Unlike the other requests, responses with a status code outside of 2xx
+	/// are sent as errors, without their body being written or hashed.
+	func hashingDownload(with request: URLRequest, priority: TransferPriority = .normal) -> SignalProducer<(DownloadedFile, URLResponse), AnyError> {
+		return schedule(
+			streamingDelegate.download(with: request, in: streamingSession),
+			priority: priority,
+			retryingWhere: Transport.isOverloaded
+		)
+	}
+
+	/// Uploads the given file as the body of the given request.
+	///
+	/// As with `URLSession`, server side errors are not sent as errors, unless
+	/// the server was still overloaded after all retries.
+	func upload(with request: URLRequest, fromFile fileURL: URL, priority: TransferPriority = .low) -> SignalProducer<(Data, URLResponse), AnyError> {
+		return schedule(
+			session.reactive.upload(with: request, fromFile: fileURL).attemptMap(Transport.failIfOverloaded),
+			priority: priority,
+			retryingWhere: Transport.isOverloaded
+		)
+	}
+
+	/// Fetches the release for the given tag through the given client.
+	func release(forTag tag: String, in repository: Repository, client: Client) -> SignalProducer<(Response, Release), Client.Error> {
+		return schedule(
+			client.execute(repository.release(forTag: tag)),
+			priority: .high,
+			retryingWhere: Transport.isOverloaded
+		)
+	}
+
+	/// Downloads the given release asset from the given server, as
+	/// `Client.download(asset:)` does, computing its digest while it's written.
+	func hashingDownload(
+		asset: Release.Asset,
+		server: Server,
+		isAuthenticated: Bool,
+		priority: TransferPriority = .normal
+	) -> SignalProducer<DownloadedFile, CarthageError> {
+		var request = URLRequest(url: asset.apiURL)
+		request.setValue("application/octet-stream", forHTTPHeaderField: "Accept")
+		request.setValue(gitHubUserAgent(), forHTTPHeaderField: "User-Agent")
+		if isAuthenticated, let authorization = gitHubAuthorizationHeader(forServer: server) {
+			request.setValue(authorization, forHTTPHeaderField: "Authorization")
+		}
+
+		return hashingDownload(with: request, priority: priority)
+			.mapError { CarthageError.readFailed(asset.url, $0.error as NSError) }
+			.map { file, _ in file }
+	}
+
+	/// Whether the given status code asks the client to try again later.
+	fileprivate static func isOverloaded(statusCode: Int) -> Bool {
+		return statusCode == 429 || (500...599).contains(statusCode)
+	}
+
+	private static func isOverloaded(_ error: Client.Error) -> Bool {
+		if case let .apiError(statusCode, _, _) = error {
+			return isOverloaded(statusCode: statusCode)
+		}
+		return false
+	}
+
+	private static func isOverloaded(_ error: AnyError) -> Bool {
+		guard let error = error.error as? UnsuccessfulResponseError else {
+			return false
+		}
+		return isOverloaded(statusCode: error.statusCode)
+	}
+
+	private static func failIfOverloaded<T>(_ result: (T, URLResponse)) -> Result<(T, URLResponse), AnyError> {
+		if let response = result.1 as? HTTPURLResponse, isOverloaded(statusCode: response.statusCode) {
+			return .failure(AnyError(UnsuccessfulResponseError(url: response.url, statusCode: response.statusCode)))
+		}
+		return .success(result)
+	}
+}
+
+/// A response with a status code outside of 2xx.
+private struct UnsuccessfulResponseError: LocalizedError {
+	let url: URL?
+	let statusCode: Int
+
+	var errorDescription: String? {
+		let urlDescription = url.map { " for \($0)" } ?? ""
+		return "Server responded with status \(statusCode)\(urlDescription)"
+	}
+}
+
+/// A file downloaded by a `Transport`, with the digest of its contents.
+internal struct DownloadedFile {
+	/// The temporary file the contents were written to. It's up to the
+	/// receiver to move or remove it.
+	let url: URL
+
+	/// The hexadecimal SHA-256 digest of the contents.
+	let sha256: String
+}
+
+/// Writes the responses of the data tasks of a session to temporary files as
+/// they arrive, hashing them along the way.
+///
+/// Download tasks can't be used for this, since `URLSession` writes their
+/// contents to disk itself.
+private final class StreamingDownloadDelegate: NSObject, URLSessionDataDelegate {
+	private final class Download {
+		let fileURL: URL
+		let fileHandle: FileHandle
+		let observer: Signal<(DownloadedFile, URLResponse), AnyError>.Observer
+		var digester = SHA256Digester()
+
+		/// Set when the response was rejected before its body arrived.
+		var failure: Error?
+
+		init(fileURL: URL, fileHandle: FileHandle, observer: Signal<(DownloadedFile, URLResponse), AnyError>.Observer) {
+			self.fileURL = fileURL
+			self.fileHandle = fileHandle
+			self.observer = observer
+		}
+	}
+
+	/// Downloads in progress by the identifier of their task. Callbacks are
+	/// serialized by the session, but downloads start on other threads.
+	private var downloads: [Int: Download] = [:]
+	private let downloadsLock = NSLock()
+
+	/// Sends the downloaded file and the response to the given request, made
+	/// in the given session, which must have been created with this delegate.
+	func download(with request: URLRequest, in session: URLSession) -> SignalProducer<(DownloadedFile, URLResponse), AnyError> {
+		return SignalProducer { observer, lifetime in
+			let fileURL = FileManager.default.temporaryDirectory
+				.appendingPathComponent("carthage-download-\(UUID().uuidString)", isDirectory: false)
+			guard FileManager.default.createFile(atPath: fileURL.path, contents: nil), let fileHandle = try? FileHandle(forWritingTo: fileURL) else {
+				observer.send(error: AnyError(CarthageError.writeFailed(fileURL, nil)))
+				return
+			}
+
+			let task = session.dataTask(with: request)
+			self.downloadsLock.lock()
+			self.downloads[task.taskIdentifier] = Download(fileURL: fileURL, fileHandle: fileHandle, observer: observer)
+			self.downloadsLock.unlock()
+
+			lifetime.observeEnded { task.cancel() }
+			task.resume()
+		}
+	}
+
+	private func download(for task: URLSessionTask) -> Download? {
+		downloadsLock.lock()
+		defer { downloadsLock.unlock() }
+		return downloads[task.taskIdentifier]
+	}
+
+	func urlSession(
+		_ session: URLSession,
+		dataTask: URLSessionDataTask,
+		didReceive response: URLResponse,
+		completionHandler: @escaping (URLSession.ResponseDisposition) -> Void
+	) {
+		if let response = response as? HTTPURLResponse, !(200...299).contains(response.statusCode), let download = download(for: dataTask) {
+			download.failure = UnsuccessfulResponseError(url: response.url, statusCode: response.statusCode)
+			completionHandler(.cancel)
+			return
+		}
+
+		completionHandler(.allow)
+	}
+
+	func urlSession(_ session: URLSession, dataTask: URLSessionDataTask, didReceive data: Data) {
+		guard let download = download(for: dataTask) else {
+			return
+		}
+
+		download.fileHandle.write(data)
+		download.digester.update(with: data)
+	}
+
+	func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
+		downloadsLock.lock()
+		let download = downloads.removeValue(forKey: task.taskIdentifier)
+		downloadsLock.unlock()
+
+		guard let finishedDownload = download else {
+			return
+		}
+
+		finishedDownload.fileHandle.closeFile()
+		guard finishedDownload.failure == nil, error == nil, let response = task.response else {
+			_ = try? FileManager.default.removeItem(at: finishedDownload.fileURL)
+			finishedDownload.observer.send(error: AnyError(finishedDownload.failure ?? error ?? URLError(.badServerResponse)))
+			return
+		}
+
+		let file = DownloadedFile(url: finishedDownload.fileURL, sha256: finishedDownload.digester.finalize())
+		finishedDownload.observer.send(value: (file, response))
+		finishedDownload.observer.sendCompleted()
+	}
+}
+
+extension SignalProducer {
+	/// Shorthand for enqueuing the given producer upon the given queue with the
+	/// given priority.
+	fileprivate func startOnQueue(_ queue: ConcurrentProducerQueue, priority: Operation.QueuePriority) -> SignalProducer<Value, Error> {
+		return queue.enqueue(self.producer, priority: priority)
+	}
+}
@@ -58,6 +58,7 @@ public struct VersionFile: Codable {
 		case iOS = "iOS"
 		case watchOS = "watchOS"
 		case tvOS = "tvOS"
+		case buildInputs = "buildInputs"
 	}
 
 	/// The revision of the dependency (usually a version number)
@@ -70,6 +71,9 @@ public struct VersionFile: Codable {
 	public let watchOS: [CachedFramework]?
 	/// The tvOS cached frameworks
 	public let tvOS: [CachedFramework]?
+	/// The digest of everything the frameworks were built from, if it was
+	/// recorded. See `BuildInputs`.
+	public let buildInputs: String?
 
 	/// The extension representing a serialized VersionFile.
 	static let pathExtension = "version"
@@ -99,13 +103,15 @@ public struct VersionFile: Codable {
 		macOS: [CachedFramework]?,
 		iOS: [CachedFramework]?,
 		watchOS: [CachedFramework]?,
-		tvOS: [CachedFramework]?
+		tvOS: [CachedFramework]?,
+		buildInputs: String? = nil
 	) {
 		self.commitish = commitish
 		self.macOS = macOS
 		self.iOS = iOS
 		self.watchOS = watchOS
 		self.tvOS = tvOS
+		self.buildInputs = buildInputs
 	}
 
 	/// Initializes a version file from the content of a file
@@ -166,27 +172,37 @@ public struct VersionFile: Codable {
 
 	/// Sends the hashes of the provided cached framework's binaries in the
 	/// order that they were provided in.
+	///
+	/// Binaries which haven't changed since they were last hashed aren't
+	/// read again, unless `rehashBinaries` is true.
 	public func hashes(
 		for cachedFrameworks: [CachedFramework],
 		platform: SDK,
-		binariesDirectoryURL: URL
+		binariesDirectoryURL: URL,
+		rehashBinaries: Bool = false
 	) -> SignalProducer<String?, CarthageError> {
-		return SignalProducer<CachedFramework, CarthageError>(cachedFrameworks)
-			.flatMap(.concat) { cachedFramework -> SignalProducer<String?, CarthageError> in
+		// The binaries are hashed concurrently, so their hashes are put back
+		// in order before being sent.
+		return SignalProducer<Int, CarthageError>(cachedFrameworks.indices)
+			.flatMap(.merge) { index -> SignalProducer<(Int, String?), CarthageError> in
 				let frameworkBinaryURL = self.frameworkBinaryURL(
-					for: cachedFramework,
+					for: cachedFrameworks[index],
 					platform: platform,
 					binariesDirectoryURL: binariesDirectoryURL
 				)
 
-				return hashForFileAtURL(frameworkBinaryURL)
-					.map { hash -> String? in
-						return hash
+				return hashForFileAtURL(frameworkBinaryURL, rehash: rehashBinaries)
+					.map { hash -> (Int, String?) in
+						return (index, hash)
 					}
 					.flatMapError { _ in
-						return SignalProducer(value: nil)
+						return SignalProducer(value: (index, nil))
 					}
 			}
+			.collect()
+			.flatMap(.concat) { indexedHashes -> SignalProducer<String?, CarthageError> in
+				return SignalProducer(indexedHashes.sorted { $0.0 < $1.0 }.map { $0.1 })
+			}
 	}
 
 	/// Sends values indicating whether the provided cached frameworks match the
@@ -226,7 +242,8 @@ public struct VersionFile: Codable {
 		platform: SDK,
 		commitish: String,
 		binariesDirectoryURL: URL,
-		localSwiftVersion: String
+		localSwiftVersion: String,
+		rehashBinaries: Bool = false
 	) -> SignalProducer<Bool, CarthageError> {
 		guard let cachedFrameworks = self[platform] else {
 			return SignalProducer(value: false)
@@ -235,7 +252,8 @@ public struct VersionFile: Codable {
 		let hashes = self.hashes(
 			for: cachedFrameworks,
 			platform: platform,
-			binariesDirectoryURL: binariesDirectoryURL
+			binariesDirectoryURL: binariesDirectoryURL,
+			rehashBinaries: rehashBinaries
 		)
 			.collect()
 
@@ -286,6 +304,33 @@ public struct VersionFile: Codable {
 			}
 	}
 
+	/// Returns a copy of the version file which records the given digest of
+	/// the build inputs.
+	public func recordingBuildInputs(_ buildInputs: String) -> VersionFile {
+		return VersionFile(commitish: commitish, macOS: macOS, iOS: iOS, watchOS: watchOS, tvOS: tvOS, buildInputs: buildInputs)
+	}
+
+	/// Digests what dependents of the recorded frameworks are built against:
+	/// the hashes of their binaries and the contents of their headers, module
+	/// maps and Swift modules.
+	///
+	/// The revision the frameworks were built from isn't part of it, so a
+	/// rebuild which produces identical frameworks leaves it unchanged.
+	public func productFingerprint(binariesDirectoryURL: URL) -> String {
+		let lines = SDK.knownIn2019YearSDKs
+			.filter { $0.isDevice }
+			.sorted { $0.rawValue < $1.rawValue }
+			.flatMap { platform -> [String] in
+				(self[platform] ?? []).flatMap { cachedFramework -> [String] in
+					let frameworkURL = self.frameworkURL(for: cachedFramework, platform: platform, binariesDirectoryURL: binariesDirectoryURL)
+					return [ "\(platform.platformSimulatorlessFromHeuristic) \(cachedFramework.name) \(cachedFramework.hash)" ]
+						+ publicInterfaceDigests(ofFrameworkAt: frameworkURL)
+				}
+			}
+
+		return sha256HexDigest(of: lines.joined(separator: "\n"))
+	}
+
 	/// Writes the version file to the provided path
 	public func write(to url: URL) -> Result<(), CarthageError> {
 		return Result(at: url, attempt: {
@@ -574,6 +619,12 @@ public func createVersionFileForCommitish(
 ///
 /// If a set of platforms is not provided, all platforms are checked.
 ///
+/// If the digest of the build inputs is given, and the version file recorded
+/// one, the two have to match as well.
+///
+/// Binaries are only read to be hashed if they changed since they were last
+/// hashed, or if `rehashBinaries` is true.
+///
 /// Returns an optional bool which is nil if no version file exists,
 /// otherwise true if the version file matches and the build can be
 /// skipped or false if there is a mismatch of some kind.
@@ -582,13 +633,19 @@ public func versionFileMatches(
 	version: PinnedVersion,
 	platforms: Set<SDK>?,
 	rootDirectoryURL: URL,
-	toolchain: String?
+	toolchain: String?,
+	buildInputs: String? = nil,
+	rehashBinaries: Bool = false
 ) -> SignalProducer<Bool?, CarthageError> {
 	let versionFileURL = VersionFile.url(for: dependency, rootDirectoryURL: rootDirectoryURL)
 	guard let versionFile = VersionFile(url: versionFileURL) else {
 		return SignalProducer(value: nil)
 	}
 
+	if let buildInputs = buildInputs, let recordedBuildInputs = versionFile.buildInputs, buildInputs != recordedBuildInputs {
+		return SignalProducer(value: false)
+	}
+
 	let commitish = version.commitish
 
 	let platformsToCheck = (platforms ?? SDK.knownIn2019YearSDKs).intersection(SDK.knownIn2019YearSDKs)
@@ -606,7 +663,8 @@ public func versionFileMatches(
 						platform: platform,
 						commitish: commitish,
 						binariesDirectoryURL: rootBinariesURL,
-						localSwiftVersion: localSwiftVersion
+						localSwiftVersion: localSwiftVersion,
+						rehashBinaries: rehashBinaries
 					)
 				}
 				.reduce(true) { $0 && $1 }
@@ -614,22 +672,51 @@ public func versionFileMatches(
 		}
 }
 
-private func hashForFileAtURL(_ frameworkFileURL: URL) -> SignalProducer<String, CarthageError> {
-	guard FileManager.default.fileExists(atPath: frameworkFileURL.path) else {
-		return SignalProducer(error: .readFailed(frameworkFileURL, nil))
+/// Describes the files in the `Headers` and `Modules` directories of the
+/// framework at the given URL by their paths and digests.
+///
+/// Source info files are left out, as they only record where declarations
+/// are in the sources.
+private func publicInterfaceDigests(ofFrameworkAt frameworkURL: URL) -> [String] {
+	let rootPath = frameworkURL.resolvingSymlinksInPath().path + "/"
+
+	return [ "Headers", "Modules" ].flatMap { directoryName -> [String] in
+		let directoryURL = frameworkURL.appendingPathComponent(directoryName, isDirectory: true).resolvingSymlinksInPath()
+		guard let enumerator = FileManager.default.enumerator(
+			at: directoryURL,
+			includingPropertiesForKeys: [ .isRegularFileKey ],
+			options: [ .skipsHiddenFiles ]
+		) else {
+			return []
+		}
+
+		return enumerator
+			.compactMap { $0 as? URL }
+			.filter { fileURL in
+				fileURL.pathExtension != "swiftsourceinfo"
+					&& (try? fileURL.resourceValues(forKeys: [ .isRegularFileKey ]))?.isRegularFile == true
+			}
+			.map { fileURL in
+				let digest = sha256Digest(ofFileAt: fileURL).value ?? "unreadable"
+				return "\(fileURL.resolvingSymlinksInPath().path.stripping(prefix: rootPath)) \(digest)"
+			}
+			.sorted()
 	}
+}
 
-	let task = Task("/usr/bin/shasum", arguments: ["-a", "256", frameworkFileURL.path])
+/// Hashes framework binaries, as many at once as there are processors.
+private let hashingQueue = ConcurrentProducerQueue(
+	name: "org.carthage.CarthageKit.hashForFileAtURL",
+	limit: ProcessInfo.processInfo.activeProcessorCount
+)
 
-	return task.launch()
-		.mapError(CarthageError.taskError)
-		.ignoreTaskData()
-		.attemptMap { data in
-			guard let taskOutput = String(data: data, encoding: .utf8) else {
-				return .failure(.readFailed(frameworkFileURL, nil))
-			}
+private func hashForFileAtURL(_ frameworkFileURL: URL, rehash: Bool = false) -> SignalProducer<String, CarthageError> {
+	guard FileManager.default.fileExists(atPath: frameworkFileURL.path) else {
+		return SignalProducer(error: .readFailed(frameworkFileURL, nil))
+	}
 
-			let hashStr = taskOutput.components(separatedBy: CharacterSet.whitespaces)[0]
-			return .success(hashStr.trimmingCharacters(in: .whitespacesAndNewlines))
-		}
+	return SignalProducer { () -> Result<String, CarthageError> in
+		BinaryHashCache.hash(ofFileAt: frameworkFileURL, rehash: rehash)
+	}
+		.startOnQueue(hashingQueue)
 }
@@ -15,8 +15,7 @@ internal func swiftVersion(usingToolchain toolchain: String? = nil) -> SignalPro
 private func determineSwiftVersion(usingToolchain toolchain: String?) -> SignalProducer<String, SwiftVersionError> {
 	let taskDescription = Task("/usr/bin/env", arguments: compilerVersionArguments(usingToolchain: toolchain))
 
-	return taskDescription.launch(standardInput: nil)
-		.ignoreTaskData()
+	return ToolchainCache.output(of: taskDescription, toolchain: toolchain)
 		.mapError { _ in SwiftVersionError.unknownLocalSwiftVersion }
 		.map { data -> String? in
 			return parseSwiftVersionCommand(output: String(data: data, encoding: .utf8))
@@ -81,55 +80,25 @@ internal func frameworkSwiftVersion(_ frameworkURL: URL) -> SignalProducer<Strin
 }
 
 private func dSYMSwiftVersion(_ dSYMURL: URL) -> SignalProducer<String, SwiftVersionError> {
-	// Pick one architecture
-	guard let arch = architecturesInPackage(
-		dSYMURL,
-		xcrunQuery: ["lipo", "-info"]
-	).flatten().first()?.value else {
-		return SignalProducer(error: .unknownFrameworkSwiftVersion(message: "No architectures found in dSYM."))
-	}
-
-	// Check the .debug_info section left from the compiler in the dSYM.
-	let task = Task("/usr/bin/xcrun", arguments: ["dwarfdump", "--arch=\(arch)", "--debug-info", dSYMURL.path])
-
-	//	$ dwarfdump --debug-info Carthage/Build/iOS/Swiftz.framework.dSYM
-	//		----------------------------------------------------------------------
-	//	File: Carthage/Build/iOS/Swiftz.framework.dSYM/Contents/Resources/DWARF/Swiftz (i386)
-	//	----------------------------------------------------------------------
-	//	.debug_info contents:
-	//
-	//	0x00000000: Compile Unit: length = 0x000000ac  version = 0x0004  abbr_offset = 0x00000000  addr_size = 0x04  (next CU at 0x000000b0)
-	//
-	//	0x0000000b: TAG_compile_unit [1] *
-	//	AT_producer( "Apple Swift version 4.1.2 effective-3.3.2 (swiftlang-902.0.54 clang-902.0.39.2) -emit-object /Users/Tommaso/<redacted>
-
-	let versions: [String]?  = task.launch(standardInput: nil)
-		.ignoreTaskData()
-		.map { String(data: $0, encoding: .utf8) ?? "" }
-		.filter { !$0.isEmpty }
-		.flatMap(.merge) { (output: String) -> SignalProducer<String, NoError> in
-			output.linesProducer
+	return SignalProducer { () -> Result<String, SwiftVersionError> in
+		guard let file = binaryURL(dSYMURL).flatMap({ MachOFile.read(at: $0) }).value, !file.slices.isEmpty else {
+			return .failure(.unknownFrameworkSwiftVersion(message: "No architectures found in dSYM."))
 		}
-		.filter { $0.contains("AT_producer") }
-		.uniqueValues()
-		.map { parseSwiftVersionCommand(output: .some($0)) }
-		.skipNil()
-		.uniqueValues()
-		.collect()
-		.single()?
-		.value
 
-	let numberOfVersions = versions?.count ?? 0
-	guard numberOfVersions != 0 else {
-		return SignalProducer(error: .unknownFrameworkSwiftVersion(message: "No version found in dSYM."))
-	}
+		// Check the producer the compiler left in the .debug_info section of
+		// the dSYM, like:
+		//
+		//	AT_producer( "Apple Swift version 4.1.2 effective-3.3.2 (swiftlang-902.0.54 clang-902.0.39.2) -emit-object /Users/Tommaso/<redacted>
+		//
+		// Compile units of other languages, like those of Objective-C files
+		// in mixed frameworks, are skipped.
+		let producer = (try? file.firstCompileUnitProducer(where: { parseSwiftVersionCommand(output: $0) != nil })) ?? nil
+		guard let version = parseSwiftVersionCommand(output: producer) else {
+			return .failure(.unknownFrameworkSwiftVersion(message: "No version found in dSYM."))
+		}
 
-	guard numberOfVersions == 1 else {
-		let versionsString = versions!.joined(separator: " ")
-		return SignalProducer(error: .unknownFrameworkSwiftVersion(message: "More than one found in dSYM - \(versionsString) ."))
+		return .success(version)
 	}
-
-	return SignalProducer<String, SwiftVersionError>(value: versions!.first!)
 }
 
 /// Determines whether a framework was built with Swift
@@ -200,12 +169,41 @@ public func xcodebuildTask(_ task: String, _ buildArguments: BuildArguments, env
 
 /// Finds schemes of projects or workspaces, which Carthage should build, found
 /// within the given directory.
-public func buildableSchemesInDirectory( // swiftlint:disable:this function_body_length
+///
+/// Schemes found in a checkout are cached until its project, workspace or
+/// scheme files change.
+public func buildableSchemesInDirectory(
 	_ directoryURL: URL,
 	withConfiguration configuration: String,
 	forPlatforms platformAllowList: Set<SDK>? = nil
 ) -> SignalProducer<(Scheme, ProjectLocator), CarthageError> {
 	precondition(directoryURL.isFileURL)
+
+	return SignalProducer<(), CarthageError>(value: ())
+		.map { _ in SchemeCache.key(for: directoryURL, configuration: configuration, platforms: platformAllowList) }
+		.flatMap(.concat) { cacheKey -> SignalProducer<(Scheme, ProjectLocator), CarthageError> in
+			if let cacheKey = cacheKey, let cachedSchemes = SchemeCache.schemes(forKey: cacheKey) {
+				return SignalProducer(cachedSchemes)
+			}
+
+			return discoverBuildableSchemes(directoryURL, withConfiguration: configuration, forPlatforms: platformAllowList)
+				.collect()
+				.on(value: { schemes in
+					if let cacheKey = cacheKey, !schemes.isEmpty {
+						SchemeCache.store(schemes, forKey: cacheKey)
+					}
+				})
+				.flatMap(.concat) { schemes in SignalProducer(schemes) }
+		}
+}
+
+/// Finds the buildable schemes in the given directory by querying
+/// `xcodebuild`.
+private func discoverBuildableSchemes( // swiftlint:disable:this function_body_length
+	_ directoryURL: URL,
+	withConfiguration configuration: String,
+	forPlatforms platformAllowList: Set<SDK>?
+) -> SignalProducer<(Scheme, ProjectLocator), CarthageError> {
 	let locator = ProjectLocator
 			.locate(in: directoryURL)
 			.flatMap(.concurrent(limit: 4)) { project -> SignalProducer<(ProjectLocator, [Scheme]), CarthageError> in
@@ -376,23 +374,36 @@ private func copyBCSymbolMapsForBuildProductIntoDirectory(_ directoryURL: URL, _
 
 /// Attempts to merge the given executables into one fat binary, written to
 /// the specified URL.
+///
+/// The executables are mapped and their slices copied into place, like
+/// `lipo -create` would, without launching it.
 private func mergeExecutables(_ executableURLs: [URL], _ outputURL: URL) -> SignalProducer<(), CarthageError> {
 	precondition(outputURL.isFileURL)
 
 	return SignalProducer<URL, CarthageError>(executableURLs)
-		.attemptMap { url -> Result<String, CarthageError> in
+		.attemptMap { url -> Result<MachOFile, CarthageError> in
 			if url.isFileURL {
-				return .success(url.path)
+				return MachOFile.read(at: url)
 			} else {
 				return .failure(.parseError(description: "expected file URL to built executable, got \(url)"))
 			}
 		}
 		.collect()
-		.flatMap(.merge) { executablePaths -> SignalProducer<TaskEvent<Data>, CarthageError> in
-			let lipoTask = Task("/usr/bin/xcrun", arguments: [ "lipo", "-create" ] + executablePaths + [ "-output", outputURL.path ])
-
-			return lipoTask.launch()
-				.mapError(CarthageError.taskError)
+		.attemptMap { files -> Result<(), CarthageError> in
+			return MachOFile.merging(files)
+				.mapError { error in
+					let paths = executableURLs.map { $0.path }.joined(separator: ", ")
+					return CarthageError.invalidArchitectures(description: "Could not merge \(paths), which \(error.description)")
+				}
+				.flatMap { data in
+					Result(at: outputURL, attempt: {
+						let permissions = try FileManager.default.attributesOfItem(atPath: executableURLs[0].path)[.posixPermissions]
+						try data.write(to: $0, options: .atomic)
+						if let permissions = permissions {
+							try FileManager.default.setAttributes([ .posixPermissions: permissions ], ofItemAtPath: $0.path)
+						}
+					})
+				}
 		}
 		.then(SignalProducer<(), CarthageError>.empty)
 }
@@ -594,10 +605,10 @@ private func mergeBuildProducts(
 				.then(SignalProducer<URL, CarthageError>(value: productURL))
 		}
 		.mapError { error -> CarthageError in
-			if case .taskError(let taskError) = error,
+			if case .invalidArchitectures(let description) = error,
 				 let commonArchitectures = commonArchitectures.value,
 				 let productName = deviceBuildSettings.productName.value {
-				return .xcframeworkRequired(.init(productName: productName, commonArchitectures: commonArchitectures, underlyingError: taskError))
+				return .xcframeworkRequired(.init(productName: productName, commonArchitectures: commonArchitectures, underlyingError: description))
 			} else {
 				return error
 			}
@@ -677,14 +688,20 @@ public func buildScheme( // swiftlint:disable:this function_body_length cyclomat
 ) -> SignalProducer<TaskEvent<URL>, CarthageError> {
 	precondition(workingDirectoryURL.isFileURL)
 
-	let buildArgs = BuildArguments(
+	var buildArgs = BuildArguments(
 		project: project,
 		scheme: scheme,
 		configuration: options.configuration,
 		derivedDataPath: options.derivedDataPath,
 		toolchain: options.toolchain
 	)
+	buildArgs.moduleCachePath = options.moduleCachePath
 	let buildURL = rootDirectoryURL.appendingPathComponent(Constants.binariesFolderPath)
+	let dependencyName = workingDirectoryURL.lastPathComponent
+
+	// Concurrent builds have to share the memory and CPUs of the host, and
+	// however they are nested, no more than `jobs` of them run at once.
+	let scheduler = options.jobs > 1 ? BuildScheduler.shared : nil
 
 	return BuildSettings.SDKsForScheme(scheme, inProject: project)
 		.flatMap(.concat) { sdk -> SignalProducer<SDK, CarthageError> in
@@ -702,6 +719,7 @@ public func buildScheme( // swiftlint:disable:this function_body_length cyclomat
 				.map { _ in sdk }
 		}
 		.reduce(into: [] as Set) { $0.formUnion([$1]) }
+		.timed(.settingsDiscovery, in: options.timeline, dependency: dependencyName, scheme: scheme)
 		.flatMap(.concat) { sdks -> SignalProducer<(String, [SDK]), CarthageError> in
 			if sdks.isEmpty { fatalError("No SDKs found for scheme \(scheme)") }
 			// fatalError in unlikely case that propogated logic error from Carthage authors
@@ -721,13 +739,16 @@ public func buildScheme( // swiftlint:disable:this function_body_length cyclomat
 
 			switch sdks.count {
 			case 1:
-				return build(sdk: sdks[0], with: buildArgs, in: workingDirectoryURL)
-					.flatMapTaskEvents(.merge) { settings in
+				return build(sdk: sdks[0], with: buildArgs, in: workingDirectoryURL, scheduler: scheduler, concurrentBuildLimit: options.jobs)
+					.timed(sdks[0].isDevice ? .archive : .compile, in: options.timeline, dependency: dependencyName, scheme: scheme, sdk: sdks[0].rawValue)
+					.flatMapTaskEvents(.merge) { settings -> SignalProducer<URL, CarthageError> in
+						let merge: SignalProducer<URL, CarthageError>
 						if options.useXCFrameworks {
-							return mergeIntoXCFramework(in: buildURL, settings: settings)
+							merge = mergeIntoXCFramework(in: buildURL, settings: settings)
 						} else {
-							return copyBuildProductIntoDirectory(settings.productDestinationPath(in: folderURL), settings)
+							merge = copyBuildProductIntoDirectory(settings.productDestinationPath(in: folderURL), settings)
 						}
+						return merge.timed(.merge, in: options.timeline, dependency: dependencyName, scheme: scheme, sdk: sdks[0].rawValue)
 					}
 
 			case 2:
@@ -739,59 +760,63 @@ public func buildScheme( // swiftlint:disable:this function_body_length cyclomat
 					fatalError("Could not find simulator SDK in \(sdks)")
 				}
 
-				return settingsByTarget(build(sdk: deviceSDK, with: buildArgs, in: workingDirectoryURL))
-					.flatMap(.concat) { settingsEvent -> SignalProducer<TaskEvent<(BuildSettings, BuildSettings)>, CarthageError> in
-						switch settingsEvent {
-						case let .launch(task):
-							return SignalProducer(value: .launch(task))
-
-						case let .standardOutput(data):
-							return SignalProducer(value: .standardOutput(data))
-
-						case let .standardError(data):
-							return SignalProducer(value: .standardError(data))
-
-						case let .success(deviceSettingsByTarget):
-							return settingsByTarget(
-								build(sdk: simulatorSDK,
-									  with: buildArgs,
-									  in: workingDirectoryURL)
-								)
-								.flatMapTaskEvents(.concat) { (simulatorSettingsByTarget: [String: BuildSettings]) -> SignalProducer<(BuildSettings, BuildSettings), CarthageError> in
-									assert(
-										deviceSettingsByTarget.count == simulatorSettingsByTarget.count,
-										"Number of targets built for \(deviceSDK) (\(deviceSettingsByTarget.count)) does not match "
-											+ "number of targets built for \(simulatorSDK) (\(simulatorSettingsByTarget.count))"
-									)
-
-									return SignalProducer { observer, lifetime in
-										for (target, deviceSettings) in deviceSettingsByTarget {
-											if lifetime.hasEnded {
-												break
-											}
-
-											let simulatorSettings = simulatorSettingsByTarget[target]
-											assert(simulatorSettings != nil, "No \(simulatorSDK) build settings found for target \"\(target)\"")
-
-											observer.send(value: (deviceSettings, simulatorSettings!))
-										}
-
-										observer.sendCompleted()
-									}
+				// The device and simulator builds are independent until their
+				// products get merged, so they can run side by side, each in its
+				// own part of the derived data folder.
+				let buildConcurrently = options.jobs > 1 && buildArgs.derivedDataPath != nil
+				let argumentsForSDK = { (sdk: SDK) -> BuildArguments in
+					var arguments = buildArgs
+					if buildConcurrently, let derivedDataPath = buildArgs.derivedDataPath {
+						arguments.derivedDataPath = (derivedDataPath as NSString).appendingPathComponent(sdk.rawValue)
+					}
+					return arguments
+				}
+
+				let buildForSDK = { (sdk: SDK) in
+					build(sdk: sdk, with: argumentsForSDK(sdk), in: workingDirectoryURL, scheduler: scheduler, concurrentBuildLimit: options.jobs)
+						.timed(sdk.isDevice ? .archive : .compile, in: options.timeline, dependency: dependencyName, scheme: scheme, sdk: sdk.rawValue)
+				}
+
+				return joinTaskEvents(
+						settingsByTarget(buildForSDK(deviceSDK)),
+						settingsByTarget(buildForSDK(simulatorSDK)),
+						concurrently: buildConcurrently
+					)
+					.flatMapTaskEvents(.concat) { deviceSettingsByTarget, simulatorSettingsByTarget -> SignalProducer<(BuildSettings, BuildSettings), CarthageError> in
+						assert(
+							deviceSettingsByTarget.count == simulatorSettingsByTarget.count,
+							"Number of targets built for \(deviceSDK) (\(deviceSettingsByTarget.count)) does not match "
+								+ "number of targets built for \(simulatorSDK) (\(simulatorSettingsByTarget.count))"
+						)
+
+						return SignalProducer { observer, lifetime in
+							for (target, deviceSettings) in deviceSettingsByTarget {
+								if lifetime.hasEnded {
+									break
 								}
+
+								let simulatorSettings = simulatorSettingsByTarget[target]
+								assert(simulatorSettings != nil, "No \(simulatorSDK) build settings found for target \"\(target)\"")
+
+								observer.send(value: (deviceSettings, simulatorSettings!))
+							}
+
+							observer.sendCompleted()
 						}
 					}
-					.flatMapTaskEvents(.concat) { deviceSettings, simulatorSettings in
+					.flatMapTaskEvents(.concat) { deviceSettings, simulatorSettings -> SignalProducer<URL, CarthageError> in
+						let merge: SignalProducer<URL, CarthageError>
 						if options.useXCFrameworks {
-							return mergeIntoXCFramework(in: buildURL, settings: deviceSettings)
+							merge = mergeIntoXCFramework(in: buildURL, settings: deviceSettings)
 								.concat(mergeIntoXCFramework(in: buildURL, settings: simulatorSettings))
 						} else {
-							return mergeBuildProducts(
+							merge = mergeBuildProducts(
 								deviceBuildSettings: deviceSettings,
 								simulatorBuildSettings: simulatorSettings,
 								into: deviceSettings.productDestinationPath(in: folderURL)
 							)
 						}
+						return merge.timed(.merge, in: options.timeline, dependency: dependencyName, scheme: scheme)
 					}
 
 			default:
@@ -811,11 +836,34 @@ public func buildScheme( // swiftlint:disable:this function_body_length cyclomat
 				.take(first: 1)
 				.flatMap(.concat) { _ -> SignalProducer<TaskEvent<URL>, CarthageError> in
 					return createDebugInformation(builtProductURL)
+						.timed(.debugInformation, in: options.timeline, dependency: dependencyName, scheme: scheme)
 				}
 				.then(SignalProducer<URL, CarthageError>(value: builtProductURL))
 		}
 }
 
+/// Runs both of the given builds, either one after the other or concurrently,
+/// forwarding their output as it arrives, and sends their successful values
+/// together once both have succeeded.
+private func joinTaskEvents<T, U>(
+	_ first: SignalProducer<TaskEvent<T>, CarthageError>,
+	_ second: SignalProducer<TaskEvent<U>, CarthageError>,
+	concurrently: Bool
+) -> SignalProducer<TaskEvent<(T, U)>, CarthageError> {
+	let firstEvents = first.map { taskEvent in taskEvent.map { value -> (T?, U?) in (value, nil) } }
+	let secondEvents = second.map { taskEvent in taskEvent.map { value -> (T?, U?) in (nil, value) } }
+
+	return (concurrently ? SignalProducer.merge(firstEvents, secondEvents) : firstEvents.concat(secondEvents))
+		.collectTaskEvents()
+		.flatMapTaskEvents(.concat) { values -> SignalProducer<(T, U), CarthageError> in
+			guard let firstValue = values.lazy.compactMap({ $0.0 }).first, let secondValue = values.lazy.compactMap({ $0.1 }).first else {
+				return .empty
+			}
+
+			return SignalProducer(value: (firstValue, secondValue))
+		}
+}
+
 /// Fixes problem when more than one xcode target has the same Product name for same Deployment target and configuration by deleting TARGET_BUILD_DIR.
 private func resolveSameTargetName(for settings: BuildSettings) -> SignalProducer<BuildSettings, CarthageError> {
 	switch settings.targetBuildDirectory {
@@ -898,11 +946,17 @@ func extractXCFrameworks(in buildDirectory: URL, for settings: BuildSettings) ->
 }
 
 /// Runs the build for a given sdk and build arguments, optionally performing a clean first
+///
+/// If a scheduler is given, `xcodebuild` is only launched once the scheduler
+/// admits it, with fewer than `concurrentBuildLimit` other builds running, and
+/// with as many jobs as it allows.
 // swiftlint:disable:next function_body_length
 private func build(
 	sdk: SDK,
 	with buildArgs: BuildArguments,
-	in workingDirectoryURL: URL
+	in workingDirectoryURL: URL,
+	scheduler: BuildScheduler? = nil,
+	concurrentBuildLimit: Int = 1
 ) -> SignalProducer<TaskEvent<BuildSettings>, CarthageError> {
 
 	var argsForLoading = buildArgs
@@ -1025,10 +1079,24 @@ private func build(
 						return result
 					}()
 
-					var buildScheme = xcodebuildTask(actions, argsForBuilding)
-					buildScheme.workingDirectoryPath = workingDirectoryURL.path
+					let launchBuild = { (jobs: Int?) -> SignalProducer<TaskEvent<Data>, TaskError> in
+						var argsForScheduledBuilding = argsForBuilding
+						argsForScheduledBuilding.jobs = jobs
+
+						var buildScheme = xcodebuildTask(actions, argsForScheduledBuilding)
+						buildScheme.workingDirectoryPath = workingDirectoryURL.path
+						return buildScheme.launch()
+					}
+
+					let scheduledBuild: SignalProducer<TaskEvent<Data>, TaskError>
+					if let scheduler = scheduler {
+						let key = [ buildArgs.project.fileURL.lastPathComponent, buildArgs.scheme?.name ?? "", sdk.rawValue ].joined(separator: "/")
+						scheduledBuild = scheduler.schedule(key: key, limit: concurrentBuildLimit) { jobs in launchBuild(jobs) }
+					} else {
+						scheduledBuild = launchBuild(nil)
+					}
 
-					return buildScheme.launch()
+					return scheduledBuild
 						.flatMapTaskEvents(.concat) { _ in SignalProducer(settings) }
 						.mapError(CarthageError.taskError)
 						.concat(SignalProducer { observer, _ in
@@ -1117,38 +1185,64 @@ public func buildInDirectory( // swiftlint:disable:this function_body_length
 ) -> BuildSchemeProducer {
 	precondition(directoryURL.isFileURL)
 
+	let dependencyName = directoryURL.lastPathComponent
+
 	return BuildSchemeProducer { observer, lifetime in
+		let buildSchemeInProject = { (scheme: Scheme, project: ProjectLocator, options: BuildOptions) -> SignalProducer<TaskEvent<URL>, CarthageError> in
+			let initialValue = (project, scheme)
+
+			let wrappedSDKFilter: SDKFilterCallback = { sdks, scheme, configuration, project in
+				return sdkFilter((options.platforms /* allow list */ ?? sdks).intersection(sdks), scheme, configuration, project)
+			}
+
+			return buildScheme(
+					scheme,
+					withOptions: options,
+					inProject: project,
+					rootDirectoryURL: rootDirectoryURL,
+					workingDirectoryURL: directoryURL,
+					sdkFilter: wrappedSDKFilter
+				)
+				.mapError { error -> CarthageError in
+					if case let .taskError(taskError) = error {
+						return .buildFailed(taskError, log: nil)
+					} else {
+						return error
+					}
+				}
+				.on(started: {
+					observer.send(value: .success(initialValue))
+				})
+		}
+
 		// Use SignalProducer.replayLazily to avoid enumerating the given directory
 		// multiple times.
 		buildableSchemesInDirectory(directoryURL,
 									withConfiguration: options.configuration,
 									forPlatforms: options.platforms
 			)
-			.flatMap(.concat) { (scheme: Scheme, project: ProjectLocator) -> SignalProducer<TaskEvent<URL>, CarthageError> in
-				let initialValue = (project, scheme)
-
-				let wrappedSDKFilter: SDKFilterCallback = { sdks, scheme, configuration, project in
-					return sdkFilter((options.platforms /* allow list */ ?? sdks).intersection(sdks), scheme, configuration, project)
+			.collect()
+			.timed(.settingsDiscovery, in: options.timeline, dependency: dependencyName)
+			.flatMap(.concat) { schemes -> SignalProducer<[[(Scheme, ProjectLocator)]], CarthageError> in
+				// Schemes can only be built side by side in derived data
+				// partitions, which need a derived data path to live in.
+				guard options.jobs > 1, options.derivedDataPath != nil, schemes.count > 1 else {
+					return SignalProducer(value: [ schemes ])
 				}
 
-				return buildScheme(
-						scheme,
-						withOptions: options,
-						inProject: project,
-						rootDirectoryURL: rootDirectoryURL,
-						workingDirectoryURL: directoryURL,
-						sdkFilter: wrappedSDKFilter
-					)
-					.mapError { error -> CarthageError in
-						if case let .taskError(taskError) = error {
-							return .buildFailed(taskError, log: nil)
-						} else {
-							return error
+				return independentSchemeGroups(schemes, configuration: options.configuration)
+			}
+			.flatMap(.concat) { groups -> SignalProducer<TaskEvent<URL>, CarthageError> in
+				return SignalProducer(groups)
+					.flatMap(.concurrent(limit: UInt(max(options.jobs, 1)))) { group -> SignalProducer<TaskEvent<URL>, CarthageError> in
+						var options = options
+						if groups.count > 1, let derivedDataPath = options.derivedDataPath, let firstScheme = group.first?.0 {
+							options.derivedDataPath = (derivedDataPath as NSString).appendingPathComponent(firstScheme.name)
 						}
+
+						return SignalProducer(group)
+							.flatMap(.concat) { scheme, project in buildSchemeInProject(scheme, project, options) }
 					}
-					.on(started: {
-						observer.send(value: .success(initialValue))
-					})
 			}
 			.collectTaskEvents()
 			.flatMapTaskEvents(.concat) { (urls: [URL]) -> SignalProducer<(), CarthageError> in
@@ -1159,6 +1253,7 @@ public func buildInDirectory( // swiftlint:disable:this function_body_length
 															  buildProducts: urls,
 															  rootDirectoryURL: rootDirectoryURL
 						)
+						.timed(.versionFile, in: options.timeline, dependency: dependencyName)
 						.flatMapError { _ in .empty }
 				}
 
@@ -1169,6 +1264,7 @@ public func buildInDirectory( // swiftlint:disable:this function_body_length
 					buildProducts: urls,
 					rootDirectoryURL: rootDirectoryURL
 					)
+					.timed(.versionFile, in: options.timeline, dependency: dependencyName)
 					.flatMapError { _ in .empty }
 			}
 			// Discard any Success values, since we want to
@@ -1188,6 +1284,139 @@ public func buildInDirectory( // swiftlint:disable:this function_body_length
 	}
 }
 
+/// Splits the given schemes into groups which can be built concurrently,
+/// because no scheme in one group shares a target or a product with a scheme
+/// in another.
+///
+/// The targets of a scheme are those its build settings are listed for, and
+/// those its build action references, which also covers targets that aren't
+/// listed in the build settings. Schemes whose file can't be read are
+/// assumed to share everything, so only one group is sent.
+///
+/// Schemes keep their relative order within each group.
+private func independentSchemeGroups(
+	_ schemes: [(Scheme, ProjectLocator)],
+	configuration: String
+) -> SignalProducer<[[(Scheme, ProjectLocator)]], CarthageError> {
+	return SignalProducer(schemes)
+		.flatMap(.concat) { scheme, project -> SignalProducer<Set<String>?, CarthageError> in
+			let buildArguments = BuildArguments(project: project, scheme: scheme, configuration: configuration)
+			return BuildSettings.load(with: buildArguments)
+				.collect()
+				.map { settingsByTarget -> Set<String>? in
+					var keys = Set<String>()
+					for settings in settingsByTarget {
+						let projectPath = settings.projectPath.value ?? ""
+						keys.insert("target:\(projectPath):\(settings.target)")
+						if let wrapperName = settings.wrapperName.value {
+							keys.insert("product:\(wrapperName)")
+						}
+					}
+
+					let projectPaths = settingsByTarget.compactMap { $0.projectPath.value } + [ project.fileURL.path ]
+					let referenceKeys = projectPaths.lazy
+						.compactMap { buildableReferenceKeys(of: scheme, inProjectAt: URL(fileURLWithPath: $0, isDirectory: true)) }
+						.first
+					return referenceKeys.map { keys.union($0) }
+				}
+		}
+		.collect()
+		.map { keysByScheme -> [[(Scheme, ProjectLocator)]] in
+			guard keysByScheme.allSatisfy({ $0 != nil }) else {
+				return [ schemes ]
+			}
+
+			var groups: [(keys: Set<String>, indices: [Int])] = []
+
+			for (index, keys) in keysByScheme.compactMap({ $0 }).enumerated() {
+				// Merge every group this scheme overlaps with into one.
+				let overlapping = groups.filter { !$0.keys.isDisjoint(with: keys) }
+				groups.removeAll { !$0.keys.isDisjoint(with: keys) }
+
+				let mergedKeys = overlapping.reduce(keys) { $0.union($1.keys) }
+				let mergedIndices = overlapping.flatMap { $0.indices } + [ index ]
+				groups.append((mergedKeys, mergedIndices.sorted()))
+			}
+
+			return groups
+				.sorted { $0.indices[0] < $1.indices[0] }
+				.map { group in group.indices.map { schemes[$0] } }
+		}
+}
+
+/// Describes the targets and products referenced by the build action of the
+/// given shared scheme of the project at the given URL, in the same terms as
+/// `independentSchemeGroups` describes build settings.
+///
+/// Returns nil if the project has no such scheme, or its file can't be read.
+internal func buildableReferenceKeys(of scheme: Scheme, inProjectAt projectURL: URL) -> Set<String>? {
+	let schemeURL = projectURL.appendingPathComponent("xcshareddata/xcschemes/\(scheme).xcscheme", isDirectory: false)
+	guard let parser = XMLParser(contentsOf: schemeURL) else {
+		return nil
+	}
+
+	let collector = BuildableReferenceCollector()
+	parser.delegate = collector
+	guard parser.parse() else {
+		return nil
+	}
+
+	// Containers are relative to the directory of the project.
+	let containerDirectoryURL = projectURL.deletingLastPathComponent()
+	return collector.references.reduce(into: Set<String>()) { keys, reference in
+		if let container = reference.container, let identifier = reference.identifier {
+			let containerPath = container.hasPrefix("container:") ? String(container.dropFirst("container:".count)) : container
+			let projectPath = containerDirectoryURL.appendingPathComponent(containerPath).standardizedFileURL.path
+			keys.insert("reference:\(projectPath):\(identifier)")
+		}
+		if let buildableName = reference.buildableName {
+			keys.insert("product:\(buildableName)")
+		}
+	}
+}
+
+/// Collects the `BuildableReference`s of the entries of a scheme's build
+/// action.
+private final class BuildableReferenceCollector: NSObject, XMLParserDelegate {
+	struct Reference {
+		let identifier: String?
+		let buildableName: String?
+		let container: String?
+	}
+
+	private(set) var references: [Reference] = []
+	private var isInBuildActionEntry = false
+
+	func parser(
+		_ parser: XMLParser,
+		didStartElement elementName: String,
+		namespaceURI: String?,
+		qualifiedName: String?,
+		attributes: [String: String] = [:]
+	) {
+		switch elementName {
+		case "BuildActionEntry":
+			isInBuildActionEntry = true
+
+		case "BuildableReference" where isInBuildActionEntry:
+			references.append(Reference(
+				identifier: attributes["BlueprintIdentifier"],
+				buildableName: attributes["BuildableName"],
+				container: attributes["ReferencedContainer"]
+			))
+
+		default:
+			break
+		}
+	}
+
+	func parser(_ parser: XMLParser, didEndElement elementName: String, namespaceURI: String?, qualifiedName: String?) {
+		if elementName == "BuildActionEntry" {
+			isInBuildActionEntry = false
+		}
+	}
+}
+
 public func copyAndStripFramework(
 	_ source: URL,
 	target: URL,
@@ -1196,19 +1425,20 @@ public func copyAndStripFramework(
 	queryingCodesignIdentityWith codesignIdentityQuery: SignalProducer<String?, CarthageError> = .init(value: nil),
 	copyingSymbolMapsInto symbolMapDestinationSignal: Result<URL, CarthageError>? = nil
 ) -> SignalProducer<(), CarthageError> {
-	let strippedArchitectureData = architecturesInPackage(source)
-		.flatMap(.race) { (archs: [String]) in
-			nonDestructivelyStripArchitectures(source, Set(archs).subtracting(validArchitectures))
+	// Thin the binary straight from the source into the copy.
+	let copyStrippedBinary = SignalProducer { () -> Result<(), CarthageError> in
+		return relativeBinaryURL(source).flatMap { relativeBinaryURL in
+			thinBinary(
+				relativeBinaryURL.absoluteURL,
+				keepingArchitectures: Set(validArchitectures),
+				to: target.appendingPathComponent(relativeBinaryURL.relativePath, isDirectory: false)
+			)
 		}
+	}
 
-	return SignalProducer.combineLatest(copyProduct(source, target), codesignIdentityQuery, strippedArchitectureData)
-		.flatMap(.merge) { url, codesigningIdentity, strippedArchitectureData -> SignalProducer<(), CarthageError> in
-			return SignalProducer(value: strippedArchitectureData.1.relativePath)
-				.attemptMap {
-					return Result(at: target.appendingPathComponent($0)) {
-						try strippedArchitectureData.0.write(to: $0)
-					}
-				}
+	return SignalProducer.combineLatest(copyProduct(source, target), codesignIdentityQuery)
+		.flatMap(.merge) { _, codesigningIdentity -> SignalProducer<(), CarthageError> in
+			return copyStrippedBinary
 				.concat(strippingDebugSymbols ? stripDebugSymbols(target) : .empty)
 				.concat(stripHeadersDirectory(target))
 				.concat(stripPrivateHeadersDirectory(target))
@@ -1259,11 +1489,11 @@ public func stripDSYM(_ dSYMURL: URL, keepingArchitectures: [String]) -> SignalP
 
 /// Strips a universal file from unexpected architectures.
 private func stripBinary(_ packageURL: URL, keepingArchitectures: [String]) -> SignalProducer<(), CarthageError> {
-	return architecturesInPackage(packageURL)
-		.flatMap(.race) { (packageArchs: [String]) in
-            stripArchitectures(packageURL, Set(packageArchs).subtracting(keepingArchitectures))
-				.then(SignalProducer<(), CarthageError>(value: ()))
+	return SignalProducer { () -> Result<(), CarthageError> in
+		return binaryURL(packageURL).flatMap { binaryURL in
+			thinBinary(binaryURL, keepingArchitectures: Set(keepingArchitectures), to: binaryURL)
 		}
+	}
 }
 
 /// Copies a product into the given folder. The folder will be created if it
@@ -1371,145 +1601,83 @@ extension Signal where Value: TaskEventType {
 	}
 }
 
+/// Sends the contents of the given framework's binary without the given
+/// architectures, along with the URL of the binary relative to the framework.
 public func nonDestructivelyStripArchitectures(_ frameworkURL: URL, _ architectures: Set<String>) -> SignalProducer<(Data, URL), CarthageError> {
-	return SignalProducer(value: frameworkURL)
-		.attemptMap(binaryURL)
-		.attemptMap {
-			let frameworkPathComponents = sequence(state: frameworkURL.absoluteURL.pathComponents.makeIterator(), next: {
-				$0.next() ?? ""
-			})
-
-			let suffix = zip(frameworkPathComponents, $0.pathComponents).drop(while: { $0 == $1 })
-
-			if suffix.contains(where: { $0.0 != "" }) {
-				return .failure(CarthageError.internalError(description: "In attempt to read NSBundle «\(frameworkURL.absoluteString)»'s binary url, could not relativize «\($0.debugDescription)» against «\(frameworkURL.absoluteString)»."))
-			}
-			return Result(
-				URLComponents(string: suffix.map { $0.1 }.joined(separator: "/"))?
-					.url(relativeTo: frameworkURL.absoluteURL.appendingPathComponent("/")),
-				failWith: CarthageError.internalError(description: "In attempt to read NSBundle «\(frameworkURL.absoluteString)»'s binary url, could not relativize «\($0.debugDescription)» against «\(frameworkURL.absoluteString)».")
-			)
-		}
-		.zip(with: FileManager.default.reactive.createTemporaryDirectoryWithTemplate("carthage-lipo-XXXXXX"))
-		.flatMap(.race) { (relativeBinaryURL: URL, tempDir: URL) -> SignalProducer<(Data, URL), CarthageError> in
-			let outputURL = URL(string: relativeBinaryURL.relativePath, relativeTo: tempDir)!
-
-			let command: [String] = {
-				if architectures.isEmpty { return [ "-create" ] } // creating just the contents of the original
-				return architectures.flatMap { [ "-remove", $0 ] } // creating a binary removing the specified
-			}()
-
-			let arguments = [
-				[ relativeBinaryURL.absoluteURL.path ],
-				command,
-				[ "-output", outputURL.path ],
-			].reduce(into: ["lipo"]) { $0.append(contentsOf: $1) }
-
-			let task = Task("/usr/bin/xcrun", arguments: arguments)
-				.launch()
-				.attempt { _ in
-					try? FileManager.default.createDirectory(at: outputURL.deletingLastPathComponent(), withIntermediateDirectories: true)
-					return .success(())
-				}
-				.mapError(CarthageError.taskError)
-
-			let result: SignalProducer<(Data, URL), CarthageError> = SignalProducer(value: outputURL)
-				.attemptMap {
-					Result(at: $0, carthageError: CarthageError.readFailed) { url in
-						defer { try? FileManager.default.removeItem(at: url) }
-						return try Data(contentsOf: url)
+	return SignalProducer { () -> Result<(Data, URL), CarthageError> in
+		return relativeBinaryURL(frameworkURL).flatMap { relativeBinaryURL in
+			let binaryURL = relativeBinaryURL.absoluteURL
+			return MachOFile.read(at: binaryURL)
+				.flatMap { file in
+					file.removingArchitectures(architectures).mapError { error in
+						CarthageError.invalidArchitectures(description: "\(binaryURL.path) \(error.description)")
 					}
-						.fanout(.success(relativeBinaryURL))
 				}
-
-			return task.then(result)
+				.map { ($0, relativeBinaryURL) }
 		}
+	}
 }
 
-/// Strips the given architectures from a framework.
-private func stripArchitectures(_ packageURL: URL, _ architectures: Set<String>) -> SignalProducer<(), CarthageError> {
-	return SignalProducer<URL, CarthageError> { () -> Result<URL, CarthageError> in binaryURL(packageURL) }
-		.flatMap(.merge) { binaryURL -> SignalProducer<(), CarthageError> in
-            // If there are no architectures to be stripped, then we don't
-            // need the lipo command at all. In fact, the assigment to arguments
-            // below would actually produce invalid input to the lipo command, with
-            // no -remove arguments
-            guard architectures.count > 0 else {
-                return SignalProducer<(), CarthageError>.empty
-            }
-
-            let arguments = [
-				[ binaryURL.absoluteURL.path ],
-				architectures.flatMap { [ "-remove", $0 ] },
-				[ "-output",  binaryURL.absoluteURL.path ],
-			].reduce(into: ["lipo"]) { $0.append(contentsOf: $1) }
-
-			let lipoTask = Task("/usr/bin/xcrun", arguments: arguments)
-			return lipoTask
-				.launch()
-				.mapError(CarthageError.taskError)
-				.then(SignalProducer<(), CarthageError>.empty)
+/// Returns the URL of the binary of the given framework, relative to the
+/// framework.
+private func relativeBinaryURL(_ frameworkURL: URL) -> Result<URL, CarthageError> {
+	return binaryURL(frameworkURL).flatMap { binaryURL in
+		let frameworkPathComponents = sequence(state: frameworkURL.absoluteURL.pathComponents.makeIterator(), next: {
+			$0.next() ?? ""
+		})
+
+		let suffix = zip(frameworkPathComponents, binaryURL.pathComponents).drop(while: { $0 == $1 })
+
+		if suffix.contains(where: { $0.0 != "" }) {
+			return .failure(CarthageError.internalError(description: "In attempt to read NSBundle «\(frameworkURL.absoluteString)»'s binary url, could not relativize «\(binaryURL.debugDescription)» against «\(frameworkURL.absoluteString)»."))
 		}
+		return Result(
+			URLComponents(string: suffix.map { $0.1 }.joined(separator: "/"))?
+				.url(relativeTo: frameworkURL.absoluteURL.appendingPathComponent("/")),
+			failWith: CarthageError.internalError(description: "In attempt to read NSBundle «\(frameworkURL.absoluteString)»'s binary url, could not relativize «\(binaryURL.debugDescription)» against «\(frameworkURL.absoluteString)».")
+		)
+	}
 }
 
-// Returns a signal of all architectures present in a given package.
-public func architecturesInPackage(_ packageURL: URL, xcrunQuery: [String] = ["lipo", "-info"]) -> SignalProducer<[String], CarthageError> {
-	let binaryURLResult = binaryURL(packageURL)
-	guard let binaryURL = binaryURLResult.value else { return SignalProducer(error: binaryURLResult.error!) }
+/// Writes the given binary, with only the given architectures, to the
+/// destination, reading it once from a memory map instead of running `lipo`.
+/// The destination, which may be the binary itself, keeps the permissions of
+/// the binary.
+///
+/// If there are no other architectures to remove, the destination is left as
+/// it is.
+private func thinBinary(_ binaryURL: URL, keepingArchitectures: Set<String>, to destinationURL: URL) -> Result<(), CarthageError> {
+	return MachOFile.read(at: binaryURL).flatMap { file in
+		let architectures = Set(file.architectures).subtracting(keepingArchitectures)
+		guard !architectures.isEmpty else {
+			return .success(())
+		}
 
-	return Task("/usr/bin/xcrun", arguments: xcrunQuery + [binaryURL.path])
-		.launch()
-		.ignoreTaskData()
-		.mapError(CarthageError.taskError)
-		.map { String(data: $0, encoding: .utf8) ?? "" }
-		.attemptMap { output -> Result<[String], CarthageError> in
-			var characterSet = CharacterSet.alphanumerics
-			characterSet.insert(charactersIn: " _-")
-
-			let scanner = Scanner(string: output)
-
-			if scanner.scanString("Architectures in the fat file:", into: nil) {
-				// The output of "lipo -info PathToBinary" for fat files
-				// looks roughly like so:
-				//
-				//     Architectures in the fat file: PathToBinary are: armv7 arm64
-				//
-				var architectures: NSString?
-
-				scanner.scanString(binaryURL.path, into: nil)
-				scanner.scanString("are:", into: nil)
-				scanner.scanCharacters(from: characterSet, into: &architectures)
-
-				let components = architectures?
-					.components(separatedBy: " ")
-					.filter { !$0.isEmpty }
-
-				if let components = components {
-					return .success(components)
-				}
+		return file.removingArchitectures(architectures)
+			.mapError { error in
+				CarthageError.invalidArchitectures(description: "Could not remove \(architectures.sorted().joined(separator: ", ")) from \(binaryURL.path), which \(error.description)")
 			}
-
-			if scanner.scanString("Non-fat file:", into: nil) {
-				// The output of "lipo -info PathToBinary" for thin
-				// files looks roughly like so:
-				//
-				//     Non-fat file: PathToBinary is architecture: x86_64
-				//
-				var architecture: NSString?
-
-				scanner.scanString(binaryURL.path, into: nil)
-				scanner.scanString("is architecture:", into: nil)
-				scanner.scanCharacters(from: characterSet, into: &architecture)
-
-				if let architecture = architecture {
-					return .success([architecture.replacingOccurrences(of: "\0", with: "")])
-				}
+			.flatMap { data in
+				Result(at: destinationURL.resolvingSymlinksInPath(), attempt: {
+					let permissions = try FileManager.default.attributesOfItem(atPath: binaryURL.path)[.posixPermissions]
+					try data.write(to: $0, options: .atomic)
+					if let permissions = permissions {
+						try FileManager.default.setAttributes([ .posixPermissions: permissions ], ofItemAtPath: $0.path)
+					}
+				})
 			}
+	}
+}
 
-			// think I changed the output of the below error (which used to use packageURL.path)
-			return .failure(.invalidArchitectures(description: "Could not read architectures from \(packageURL.path)"))
+/// Returns a signal of all architectures present in a given package.
+public func architecturesInPackage(_ packageURL: URL) -> SignalProducer<[String], CarthageError> {
+	return SignalProducer { () -> Result<[String], CarthageError> in
+		return binaryURL(packageURL).flatMap { binaryURL in
+			MachOFile.read(at: binaryURL)
+				.map { $0.architectures }
+				.mapError { _ in .invalidArchitectures(description: "Could not read architectures from \(packageURL.path)") }
 		}
-		.reduce(into: [] as [String]) { $0.append(contentsOf: $1 as [String]) }
+	}
 }
 
 /// Strips debug symbols from the given framework
@@ -1553,15 +1721,24 @@ private func stripDirectory(named directory: String, of frameworkURL: URL) -> Si
 	}
 }
 
-/// Sends a set of UUIDs for each architecture present in the given framework.
+/// Sends the set of UUIDs of the architectures present in the given framework,
+/// or completes with no values if it has none, like static frameworks
+/// packaged like dynamic frameworks.
 public func UUIDsForFramework(_ frameworkURL: URL) -> SignalProducer<Set<UUID>, CarthageError> {
 	return SignalProducer { () -> Result<URL, CarthageError> in binaryURL(frameworkURL) }
-		.flatMap(.merge, UUIDsFromDwarfdump)
+		.flatMap(.merge) { binaryURL in UUIDsInMachOFiles([ binaryURL ]) }
 }
 
-/// Sends a set of UUIDs for each architecture present in the given dSYM.
+/// Sends the set of UUIDs of the architectures present in the given dSYM.
 public func UUIDsForDSYM(_ dSYMURL: URL) -> SignalProducer<Set<UUID>, CarthageError> {
-	return UUIDsFromDwarfdump(dSYMURL)
+	let dwarfDirectoryURL = dSYMURL.appendingPathComponent("Contents/Resources/DWARF", isDirectory: true)
+
+	return SignalProducer { () -> Result<[URL], CarthageError> in
+			return Result(at: dwarfDirectoryURL, attempt: {
+				try FileManager.default.contentsOfDirectory(at: $0, includingPropertiesForKeys: nil, options: [ .skipsHiddenFiles ])
+			})
+		}
+		.flatMap(.merge, UUIDsInMachOFiles)
 }
 
 /// Sends an URL for each bcsymbolmap file for the given framework.
@@ -1577,54 +1754,22 @@ public func BCSymbolMapsForFramework(_ frameworkURL: URL) -> SignalProducer<URL,
 		}
 }
 
-/// Sends a set of UUIDs for each architecture present in the given URL.
-private func UUIDsFromDwarfdump(_ url: URL) -> SignalProducer<Set<UUID>, CarthageError> {
-	let dwarfdumpTask = Task("/usr/bin/xcrun", arguments: [ "dwarfdump", "--uuid", url.path ])
-
-	return dwarfdumpTask.launch()
-		.ignoreTaskData()
-		.mapError(CarthageError.taskError)
-		.map { String(data: $0, encoding: .utf8) ?? "" }
-		// If there are no dSYMs (the output is empty but has a zero exit 
-		// status), complete with no values. This can occur if this is a "fake"
-		// framework, meaning a static framework packaged like a dynamic 
-		// framework.
-		.filter { !$0.isEmpty }
-		.flatMap(.merge) { output -> SignalProducer<Set<UUID>, CarthageError> in
-			// UUIDs are letters, decimals, or hyphens.
-			var uuidCharacterSet = CharacterSet()
-			uuidCharacterSet.formUnion(.letters)
-			uuidCharacterSet.formUnion(.decimalDigits)
-			uuidCharacterSet.formUnion(CharacterSet(charactersIn: "-"))
-
-			let scanner = Scanner(string: output)
+/// Sends the set of UUIDs in the `LC_UUID` load commands of the given Mach-O
+/// files, read in process instead of through `dwarfdump --uuid`.
+///
+/// If there are none, completes with no values.
+private func UUIDsInMachOFiles(_ fileURLs: [URL]) -> SignalProducer<Set<UUID>, CarthageError> {
+	return SignalProducer { () -> Result<Set<UUID>, CarthageError> in
 			var uuids = Set<UUID>()
-
-			// The output of dwarfdump is a series of lines formatted as follows
-			// for each architecture:
-			//
-			//     UUID: <UUID> (<Architecture>) <PathToBinary>
-			//
-			while !scanner.isAtEnd {
-				scanner.scanString("UUID: ", into: nil)
-
-				var uuidString: NSString?
-				scanner.scanCharacters(from: uuidCharacterSet, into: &uuidString)
-
-				if let uuidString = uuidString as String?, let uuid = UUID(uuidString: uuidString) {
-					uuids.insert(uuid)
+			for fileURL in fileURLs {
+				guard let file = MachOFile.read(at: fileURL).value else {
+					return .failure(.invalidUUIDs(description: "Could not read UUIDs from \(fileURL.path)"))
 				}
-
-				// Scan until a newline or end of file.
-				scanner.scanUpToCharacters(from: .newlines, into: nil)
-			}
-
-			if !uuids.isEmpty {
-				return SignalProducer(value: uuids)
-			} else {
-				return SignalProducer(error: .invalidUUIDs(description: "Could not parse UUIDs using dwarfdump from \(url.path)"))
+				uuids.formUnion(file.uuids)
 			}
+			return .success(uuids)
 		}
+		.filter { !$0.isEmpty }
 }
 
 /// Returns the URL of a binary inside a given package.
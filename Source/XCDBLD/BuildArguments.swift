@@ -56,6 +56,13 @@ public struct BuildArguments {
 	/// The build setting whether full bitcode should be embedded in the binary.
 	public var bitcodeGenerationMode: BitcodeGenerationMode?
 
+	/// The maximum number of concurrent build operations.
+	public var jobs: Int?
+
+	/// The path to the directory in which Clang and Swift cache implicitly
+	/// built modules, if it's to be shared with other builds.
+	public var moduleCachePath: String?
+
 	public init(
 		project: ProjectLocator,
 		scheme: Scheme? = nil,
@@ -123,6 +130,10 @@ public struct BuildArguments {
 			args += [ "-destination-timeout", String(destinationTimeout) ]
 		}
 
+		if let jobs = jobs {
+			args += [ "-jobs", String(jobs) ]
+		}
+
 		if let onlyActiveArchitecture = onlyActiveArchitecture {
 			if onlyActiveArchitecture {
 				args += [ "ONLY_ACTIVE_ARCH=YES" ]
@@ -131,6 +142,10 @@ public struct BuildArguments {
 			}
 		}
 
+		if let moduleCachePath = moduleCachePath {
+			args += [ "MODULE_CACHE_DIR=\(moduleCachePath)" ]
+		}
+
 		// Disable code signing requirement for all builds
 		// Frameworks get signed in the copy-frameworks action
 		args += [ "CODE_SIGNING_REQUIRED=NO", "CODE_SIGN_IDENTITY=" ]
@@ -141,8 +141,17 @@ extension SDK {
 	/// - Note: Will omit SDKs — like DriverKit — where `canonicalName` and `platform`
 	///         do not share a common prefix.
 	public static let setFromJSONShowSDKs: SignalProducer<Set<SDK>?, NoError> =
-		Task("/usr/bin/xcrun", arguments: ["xcodebuild", "-showsdks", "-json"])
-			.launch()
+		SDK.parseJSONShowSDKs(SDK.jsonShowSDKsTask.launch())
+
+	/// The task which lists the SDKs of the selected Xcode.
+	public static let jsonShowSDKsTask = Task("/usr/bin/xcrun", arguments: ["xcodebuild", "-showsdks", "-json"])
+
+	/// Parses the output of `SDK.jsonShowSDKsTask`, as sent by the given
+	/// producer.
+	///
+	/// - See: `SDK.setFromJSONShowSDKs`
+	public static func parseJSONShowSDKs(_ showSDKsOutput: SignalProducer<TaskEvent<Data>, TaskError>) -> SignalProducer<Set<SDK>?, NoError> {
+		return showSDKsOutput
 			.materializeResults() // to map below and ignore errors
 			.filterMap { try? JSONSerialization.jsonObject(with: $0.value?.value ?? Data(bytes: []), options: JSONSerialization.ReadingOptions()) as? NSArray ?? NSArray() }
 			.map {
@@ -190,6 +199,7 @@ extension SDK {
 				guard $0 == nil else { return }
 				$0 = Set($1)
 			}
+	}
 }
 
 extension SDK: CustomStringConvertible {
@@ -13,7 +13,8 @@ public struct XcodeVersion {
 		self.buildVersion = buildVersion
 	}
 
-	internal init?(xcodebuildOutput: String) {
+	/// Parses the output of `xcodebuild -version`.
+	public init?(xcodebuildOutput: String) {
 		let range = NSRange(xcodebuildOutput.startIndex..., in: xcodebuildOutput)
 		guard let match = XcodeVersion.regex.firstMatch(in: xcodebuildOutput, range: range) else {
 			return nil
@@ -28,9 +29,11 @@ public struct XcodeVersion {
 	// swiftlint:disable next force_try
 	private static let regex = try! NSRegularExpression(pattern: "Xcode ([0-9.]+)\\nBuild version (.+)")
 
+	/// The task which queries the version of the selected Xcode.
+	public static let versionTask = Task("/usr/bin/xcrun", arguments: ["xcodebuild", "-version"])
+
 	public static func make() -> XcodeVersion? {
-		let task = Task("/usr/bin/xcrun", arguments: ["xcodebuild", "-version"])
-		return task.launch()
+		return versionTask.launch()
 			.ignoreTaskData()
 			.map { String(data: $0, encoding: .utf8)! }
 			.flatMap(.concat) { output -> SignalProducer<XcodeVersion, TaskError> in
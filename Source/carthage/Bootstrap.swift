@@ -14,13 +14,15 @@ public struct BootstrapCommand: CommandProtocol {
 		// `update` flags.
 		return options.loadProject()
 			.flatMap(.merge) { project -> SignalProducer<(), CarthageError> in
+				project.rehashBinaries = options.buildOptions.rehashBinaries
+
 				if !FileManager.default.fileExists(atPath: project.resolvedCartfileURL.path) {
 					let formatting = options.checkoutOptions.colorOptions.formatting
 					carthage.println(formatting.bullets + "No Cartfile.resolved found, updating dependencies")
 					return project.updateDependencies(
 						shouldCheckout: options.checkoutAfterUpdate,
 						useNewResolver: options.useNewResolver,
-						buildOptions: options.buildOptions)
+						buildOptions: options.checkoutBuildOptions)
 				}
 
 				let checkDependencies: SignalProducer<(), CarthageError>
@@ -42,7 +44,7 @@ public struct BootstrapCommand: CommandProtocol {
 
 				let checkoutDependencies: SignalProducer<(), CarthageError>
 				if options.checkoutAfterUpdate {
-					checkoutDependencies = project.checkoutResolvedDependencies(options.dependenciesToUpdate, buildOptions: options.buildOptions)
+					checkoutDependencies = project.checkoutResolvedDependencies(options.dependenciesToUpdate, buildOptions: options.checkoutBuildOptions)
 				} else {
 					checkoutDependencies = .empty
 				}
@@ -25,6 +25,16 @@ extension BuildOptions: OptionsProtocol {
 			<*> mode <| Option(key: "cache-builds", defaultValue: false, usage: "use cached builds when possible")
 			<*> mode <| Option(key: "use-binaries", defaultValue: true, usage: "don't use downloaded binaries when possible")
 			<*> mode <| Option(key: "use-xcframeworks", defaultValue: false, usage: "create xcframework bundles instead of one framework per platform (requires Xcode 12+)")
+			<*> mode <| Option<String?>(
+				key: "artifact-cache",
+				defaultValue: ProcessInfo.processInfo.environment["CARTHAGE_ARTIFACT_CACHE"],
+				usage: "URL or path of a shared cache to fetch built dependencies from and upload them to (defaults to $CARTHAGE_ARTIFACT_CACHE)" + addendum
+			)
+			<*> mode <| Option(key: "jobs", defaultValue: 1, usage: "the maximum number of dependencies to build concurrently, once the dependencies they need have been built" + addendum)
+			<*> mode <| Option<String?>(key: "timing-report", defaultValue: nil, usage: "path to write a JSON summary of the time spent in each build phase to" + addendum)
+			<*> mode <| Option<String?>(key: "timing-trace", defaultValue: nil, usage: "path to write the build phases to as a Chrome trace" + addendum)
+			<*> mode <| Option(key: "shared-module-cache", defaultValue: true, usage: "don't share the Clang and Swift module caches between dependencies" + addendum)
+			<*> mode <| Option(key: "rehash-binaries", defaultValue: false, usage: "hash cached framework binaries again even if they haven't changed since they were last hashed" + addendum)
 	}
 }
 
@@ -124,7 +134,57 @@ public struct BuildCommand: CommandProtocol {
 						}
 					)
 					.then(SignalProducer<(), CarthageError>.empty)
+					.flatMapError { error -> SignalProducer<(), CarthageError> in
+						// The reports of a failed build show where its time went
+						// up to the failure, which is reported over any failure
+						// to write them.
+						return self.writeTimingReports(options.buildOptions)
+							.flatMapError { _ in .empty }
+							.then(SignalProducer(error: error))
+					}
+					.concat(self.writeTimingReports(options.buildOptions))
+					.concat(self.pruneDerivedDataInBackground())
+			}
+	}
+
+	/// Starts `carthage prune-derived-data` in a process of its own, so that
+	/// derived data, cached builds and the caches of queries and lookups are
+	/// kept within the limits configured in the environment without the build
+	/// waiting for it.
+	///
+	/// Only Carthage's own derived data folder is pruned in the background. A
+	/// custom one passed with `--derived-data` may be shared with Xcode or
+	/// other tools, so it's left to explicit runs of the command.
+	private func pruneDerivedDataInBackground() -> SignalProducer<(), CarthageError> {
+		return SignalProducer { () -> Result<(), CarthageError> in
+			guard let executablePath = Bundle.main.executablePath else {
+				return .success(())
+			}
+
+			let process = Process()
+			process.launchPath = executablePath
+			process.arguments = [ PruneDerivedDataCommand().verb, "--quiet" ]
+			process.standardOutput = FileHandle.nullDevice
+			process.standardError = FileHandle.nullDevice
+			process.launch()
+
+			return .success(())
+		}
+	}
+
+	/// Writes the timing report and trace of the build, if they were
+	/// requested.
+	private func writeTimingReports(_ options: BuildOptions) -> SignalProducer<(), CarthageError> {
+		return SignalProducer { () -> Result<(), CarthageError> in
+			guard let timeline = options.timeline else {
+				return .success(())
 			}
+
+			let writeSummary = options.timingReportPath.map { timeline.writeSummary(to: URL(fileURLWithPath: $0, isDirectory: false)) }
+			let writeTrace = options.timingTracePath.map { timeline.writeChromeTrace(to: URL(fileURLWithPath: $0, isDirectory: false)) }
+
+			return (writeSummary ?? .success(())).flatMap { writeTrace ?? .success(()) }
+		}
 	}
 
 	/// Builds the project in the given directory, using the given options.
@@ -135,6 +195,7 @@ public struct BuildCommand: CommandProtocol {
 
 		let project = Project(directoryURL: directoryURL)
 		project.useNetrc = options.useNetrc
+		project.rehashBinaries = options.buildOptions.rehashBinaries
 		var eventSink = ProjectEventSink(colorOptions: options.colorOptions)
 		project.projectEvents.observeValues { eventSink.put($0) }
 
@@ -118,11 +118,28 @@ internal struct ProjectEventSink {
 
 		case let .rebuildingCached(dependency):
 			carthage.println(formatting.bullets + "Invalid cache found for " + formatting.projectName(dependency.name)
-				+ ", rebuilding with all downstream dependencies")
+				+ ", rebuilding along with any downstream dependencies it changes")
+
+		case let .skippedBuildingUnchanged(dependency):
+			carthage.println(formatting.bullets + "Valid cache found for " + formatting.projectName(dependency.name)
+				+ " and its rebuilt dependencies are unchanged, skipping build")
 
 		case let .buildingUncached(dependency):
 			carthage.println(formatting.bullets + "No cache found for " + formatting.projectName(dependency.name)
-				+ ", building with all downstream dependencies")
+				+ ", building along with any downstream dependencies it changes")
+
+		case let .installingCachedArtifact(dependency):
+			carthage.println(formatting.bullets + "Installing " + formatting.projectName(dependency.name) + " from the artifact cache")
+
+		case let .uploadingArtifact(dependency):
+			carthage.println(formatting.bullets + "Uploading " + formatting.projectName(dependency.name) + " to the artifact cache")
+
+		case let .skippedUploadingArtifact(dependency, message):
+			carthage.println(formatting.bullets + "Skipped uploading " + formatting.projectName(dependency.name)
+				+ " to the artifact cache due to the error:\n\t" + formatting.quote(message))
+
+		case let .installingCachedBuild(dependency):
+			carthage.println(formatting.bullets + "Installing " + formatting.projectName(dependency.name) + " from the build cache")
 		}
 	}
 }
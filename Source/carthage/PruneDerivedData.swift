@@ -0,0 +1,111 @@
+import CarthageKit
+import Commandant
+import Foundation
+import Result
+import ReactiveSwift
+import Curry
+
+/// Type that encapsulates the configuration and evaluation of the `prune-derived-data` subcommand.
+public struct PruneDerivedDataCommand: CommandProtocol {
+	public struct Options: OptionsProtocol {
+		public let maximumSize: Int
+		public let maximumAge: Int
+		public let derivedDataPath: String?
+		public let isQuiet: Bool
+		public let colorOptions: ColorOptions
+
+		/// The policy described by the options, where limits of 0 mean no
+		/// limit.
+		public var policy: DerivedDataPolicy {
+			return DerivedDataPolicy(
+				maximumSize: maximumSize > 0 ? UInt64(maximumSize) << 30 : nil,
+				maximumAge: maximumAge > 0 ? TimeInterval(maximumAge) * 24 * 60 * 60 : nil
+			)
+		}
+
+		public static func evaluate(_ mode: CommandMode) -> Result<Options, CommandantError<CarthageError>> {
+			let environment = ProcessInfo.processInfo.environment
+
+			return curry(Options.init)
+				<*> mode <| Option(
+					key: "max-size",
+					defaultValue: environment["CARTHAGE_DERIVED_DATA_MAX_SIZE"].flatMap(Int.init) ?? 0,
+					usage: "the most gigabytes of derived data to keep, removing the least recently used first (defaults to $CARTHAGE_DERIVED_DATA_MAX_SIZE, or no limit)"
+				)
+				<*> mode <| Option(
+					key: "max-age",
+					defaultValue: environment["CARTHAGE_DERIVED_DATA_MAX_AGE"].flatMap(Int.init) ?? 30,
+					usage: "the number of days derived data may go unused before it's removed, or 0 for no limit (defaults to $CARTHAGE_DERIVED_DATA_MAX_AGE, or 30)"
+				)
+				<*> mode <| Option<String?>(key: "derived-data", defaultValue: nil, usage: "path to the custom derived data folder")
+				<*> mode <| Option(key: "quiet", defaultValue: false, usage: "don't list the removed derived data")
+				<*> ColorOptions.evaluate(mode)
+		}
+	}
+
+	public let verb = "prune-derived-data"
+	public let function = "Remove the derived data and cached builds of dependencies which haven't been used recently"
+
+	public func run(_ options: Options) -> Result<(), CarthageError> {
+		let directoryURL = options.derivedDataPath.map { URL(fileURLWithPath: $0, isDirectory: true) } ?? Constants.Dependency.derivedDataURL
+		let formatting = options.colorOptions.formatting
+		let byteCountFormatter = ByteCountFormatter()
+
+		// Module caches of Xcodes which aren't used anymore go after the same
+		// time as derived data.
+		let removeModuleCaches = options.policy.maximumAge
+			.map { maximumAge -> SignalProducer<(), CarthageError> in
+				ModuleCache()
+					.removeCaches(unusedFor: maximumAge)
+					.on(value: { cacheURL in
+						guard !options.isQuiet else { return }
+						carthage.println(formatting.bullets + "Removed module cache " + formatting.path(cacheURL.path))
+					})
+					.then(SignalProducer<(), CarthageError>.empty)
+			}
+			?? .empty
+
+		// So do the cached outputs of queries and lookups, which pile up as
+		// dependencies, projects and Xcodes change.
+		let cacheDirectoryURLs = [
+			Constants.Dependency.buildSettingsURL,
+			Constants.Dependency.schemesURL,
+			Constants.Dependency.releasesURL,
+			Constants.Dependency.toolchainsURL,
+		]
+		let removeCacheEntries = options.policy.maximumAge
+			.map { maximumAge -> SignalProducer<(), CarthageError> in
+				SignalProducer<URL, CarthageError>(cacheDirectoryURLs)
+					.flatMap(.concat) { CacheDirectory(url: $0).removeEntries(unusedFor: maximumAge) }
+					.then(SignalProducer<(), CarthageError>.empty)
+			}
+			?? .empty
+
+		// So do builds in the build cache, which would otherwise grow without
+		// bound.
+		let pruneBuildCache = LocalBuildCache()
+			.prune(options.policy)
+			.on(value: { archiveURL in
+				guard !options.isQuiet else { return }
+				carthage.println(formatting.bullets + "Removed cached build " + formatting.path(archiveURL.path))
+			})
+			.then(SignalProducer<(), CarthageError>.empty)
+
+		return DerivedDataStore(directoryURL: directoryURL)
+			.prune(options.policy)
+			.on(value: { entry in
+				guard !options.isQuiet else { return }
+				carthage.println(formatting.bullets + "Removed " + formatting.path(entry.url.path)
+					+ " (" + byteCountFormatter.string(fromByteCount: Int64(entry.size)) + ")")
+			})
+			.reduce(0) { $0 + $1.size }
+			.on(value: { removedSize in
+				guard !options.isQuiet else { return }
+				carthage.println(formatting.bullets + "Freed " + byteCountFormatter.string(fromByteCount: Int64(removedSize)))
+			})
+			.then(pruneBuildCache)
+			.then(removeModuleCaches)
+			.then(removeCacheEntries)
+			.waitOnCommand()
+	}
+}
@@ -33,6 +33,14 @@ public struct UpdateCommand: CommandProtocol {
 			)
 		}
 		
+		/// The build options to check out with, or nil if the dependencies will
+		/// not be built afterwards.
+		///
+		/// Binaries are only prefetched during checkout when building follows.
+		public var checkoutBuildOptions: CarthageKit.BuildOptions? {
+			return buildAfterUpdate ? buildOptions : nil
+		}
+
 		/// If `checkoutAfterUpdate` and `buildAfterUpdate` are both true, this will
 		/// be a producer representing the work necessary to build the project.
 		///
@@ -104,6 +112,7 @@ public struct UpdateCommand: CommandProtocol {
 			.flatMap(.merge) { project -> SignalProducer<(), CarthageError> in
 				
 				project.useNetrc = options.useNetrc
+				project.rehashBinaries = options.buildOptions.rehashBinaries
 				
 				let checkDependencies: SignalProducer<(), CarthageError>
 				if let depsToUpdate = options.dependenciesToUpdate {
@@ -123,7 +132,7 @@ public struct UpdateCommand: CommandProtocol {
 				}
 				
 				let updateDependencies = project.updateDependencies(
-					shouldCheckout: options.checkoutAfterUpdate, useNewResolver: options.useNewResolver, buildOptions: options.buildOptions,
+					shouldCheckout: options.checkoutAfterUpdate, useNewResolver: options.useNewResolver, buildOptions: options.checkoutBuildOptions,
 					dependenciesToUpdate: options.dependenciesToUpdate
 				)
 				
@@ -28,6 +28,7 @@ registry.register(CheckoutCommand())
 registry.register(CopyFrameworksCommand())
 registry.register(FetchCommand())
 registry.register(OutdatedCommand())
+registry.register(PruneDerivedDataCommand())
 registry.register(UpdateCommand())
 registry.register(ValidateCommand())
 registry.register(VersionCommand())
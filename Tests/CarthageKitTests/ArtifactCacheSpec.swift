@@ -0,0 +1,104 @@
+import Foundation
+import Quick
+import Nimble
+import XCDBLD
+@testable import CarthageKit
+
+class ArtifactCacheSpec: QuickSpec {
+	override func spec() {
+		let key = ArtifactCacheKey(
+			dependencyName: "ReactiveSwift",
+			commitish: "6.1.0",
+			swiftToolchainVersion: "5.1.3 (swiftlang-1100.0.282.1 clang-1100.0.33.15)",
+			platforms: [ .macOS, .iOS ],
+			configuration: "Release",
+			useXCFrameworks: false
+		)
+
+		describe("ArtifactCacheKey") {
+			it("should place artifacts by dependency and commitish") {
+				let components = key.relativePath.components(separatedBy: "/")
+				expect(components.count) == 3
+				expect(components[0]) == "ReactiveSwift"
+				expect(components[1]) == "6.1.0"
+				expect(components[2]).to(endWith(".zip"))
+			}
+
+			it("should not depend on the order of platforms") {
+				let reordered = ArtifactCacheKey(
+					dependencyName: key.dependencyName,
+					commitish: key.commitish,
+					swiftToolchainVersion: key.swiftToolchainVersion,
+					platforms: [ .iOS, .macOS ],
+					configuration: key.configuration,
+					useXCFrameworks: key.useXCFrameworks
+				)
+				expect(reordered.relativePath) == key.relativePath
+			}
+
+			it("should distinguish toolchains and configurations") {
+				let otherToolchain = ArtifactCacheKey(
+					dependencyName: key.dependencyName,
+					commitish: key.commitish,
+					swiftToolchainVersion: "5.2 (swiftlang-1103.0.32.1 clang-1103.0.32.29)",
+					platforms: key.platforms,
+					configuration: key.configuration,
+					useXCFrameworks: key.useXCFrameworks
+				)
+				let otherConfiguration = ArtifactCacheKey(
+					dependencyName: key.dependencyName,
+					commitish: key.commitish,
+					swiftToolchainVersion: key.swiftToolchainVersion,
+					platforms: key.platforms,
+					configuration: "Debug",
+					useXCFrameworks: key.useXCFrameworks
+				)
+				expect(otherToolchain.relativePath) != key.relativePath
+				expect(otherConfiguration.relativePath) != key.relativePath
+			}
+		}
+
+		describe("DirectoryArtifactCache") {
+			let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+			let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+			let cache = DirectoryArtifactCache(directoryURL: temporaryURL.appendingPathComponent("cache", isDirectory: true))
+
+			afterEach {
+				_ = try? FileManager.default.removeItem(at: temporaryURL)
+			}
+
+			it("should miss for an unknown key") {
+				let result = cache.fetch(key).single()
+				expect(result?.value ?? nil).to(beNil())
+			}
+
+			it("should fetch a stored artifact") {
+				let archiveURL = temporaryURL.appendingPathComponent("archive.zip", isDirectory: false)
+				expect { try FileManager.default.createDirectory(at: temporaryURL, withIntermediateDirectories: true) }.notTo(throwError())
+				expect { try "foobar".write(to: archiveURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+				expect(cache.store(archiveURL, for: key).wait().error).to(beNil())
+
+				let result = cache.fetch(key).single()
+				let fetchedURL = result?.value ?? nil
+				expect(fetchedURL).notTo(beNil())
+				expect(fetchedURL.flatMap { try? String(contentsOf: $0) }) == "foobar"
+			}
+		}
+
+		describe("artifactCache(at:transport:)") {
+			let transport = Transport()
+
+			it("should create a cache for supported locations") {
+				expect(artifactCache(at: "https://cache.example.com/carthage", transport: transport).value is HTTPArtifactCache) == true
+				expect(artifactCache(at: "file:///tmp/carthage", transport: transport).value is DirectoryArtifactCache) == true
+				expect(artifactCache(at: "/tmp/carthage", transport: transport).value is DirectoryArtifactCache) == true
+			}
+
+			it("should fail for an unsupported scheme") {
+				let result = artifactCache(at: "s3://bucket/carthage", transport: transport)
+				expect(result.error) == .invalidArgument(description: "Unsupported scheme \"s3\" in artifact cache location s3://bucket/carthage; expected http, https or file")
+			}
+		}
+	}
+}
@@ -0,0 +1,69 @@
+import Foundation
+import Quick
+import Nimble
+@testable import CarthageKit
+
+class BinaryHashCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let cacheDirectoryURL = temporaryURL.appendingPathComponent("BinaryHashes", isDirectory: true)
+		let binaryURL = temporaryURL.appendingPathComponent("TestFramework.framework/TestFramework", isDirectory: false)
+		let digest = "c3ab8ff13720e8ad9047dd39466b3c8974e592c2fa383d4a3960714caef0c4f2"
+		let recordedDigest = String(repeating: "0", count: 64)
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: binaryURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try Data("foobar".utf8).write(to: binaryURL) }.notTo(throwError())
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		/// Replaces the recorded digest of the binary, so that it can be told
+		/// apart from one which was computed again.
+		func recordDigest() {
+			let entryURL = BinaryHashCache.entryURL(forFileAt: binaryURL, directoryURL: cacheDirectoryURL)
+			let entry = BinaryHashCache.Entry(attributes: BinaryHashCache.attributes(ofFileAt: binaryURL)!, sha256: recordedDigest)
+			expect { try JSONEncoder().encode(entry).write(to: entryURL, options: .atomic) }.notTo(throwError())
+		}
+
+		it("should reuse the digest of an unchanged binary") {
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) == digest
+
+			recordDigest()
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) == recordedDigest
+		}
+
+		it("should hash a binary again once it changes") {
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) == digest
+			recordDigest()
+
+			expect { try Data("foobaz".utf8).write(to: binaryURL, options: .atomic) }.notTo(throwError())
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) != recordedDigest
+		}
+
+		it("should keep one entry per binary however often it changes") {
+			for contents in [ "foobar", "foobaz", "foobarbaz" ] {
+				expect { try Data(contents.utf8).write(to: binaryURL, options: .atomic) }.notTo(throwError())
+				expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value).notTo(beNil())
+			}
+
+			expect(try? FileManager.default.contentsOfDirectory(atPath: cacheDirectoryURL.path).count) == 1
+		}
+
+		it("should hash an unchanged binary again when asked to") {
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) == digest
+			recordDigest()
+
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, rehash: true, directoryURL: cacheDirectoryURL).value) == digest
+			expect(BinaryHashCache.hash(ofFileAt: binaryURL, directoryURL: cacheDirectoryURL).value) == digest
+		}
+
+		it("should fail to hash a missing binary") {
+			let missingURL = temporaryURL.appendingPathComponent("Missing", isDirectory: false)
+			expect(BinaryHashCache.hash(ofFileAt: missingURL, directoryURL: cacheDirectoryURL).error).notTo(beNil())
+		}
+	}
+}
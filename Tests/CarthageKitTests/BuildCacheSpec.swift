@@ -0,0 +1,86 @@
+import Foundation
+import Quick
+import Nimble
+@testable import CarthageKit
+
+class BuildCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let archiveURL = temporaryURL.appendingPathComponent("Archive.zip", isDirectory: false)
+		let buildCache = LocalBuildCache(directoryURL: temporaryURL.appendingPathComponent("BuildCache", isDirectory: true))
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: temporaryURL, withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "products".write(to: archiveURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should find archives by their inputs") {
+			expect(buildCache.archiveURL(forInputs: "inputs")).to(beNil())
+
+			expect(buildCache.store(archiveURL, forInputs: "inputs").error).to(beNil())
+
+			let cachedURL = buildCache.archiveURL(forInputs: "inputs")
+			expect(cachedURL).notTo(beNil())
+			expect(cachedURL.flatMap { try? String(contentsOf: $0, encoding: .utf8) }) == "products"
+		}
+
+		it("should store identical archives once") {
+			expect(buildCache.store(archiveURL, forInputs: "inputs").error).to(beNil())
+			expect(buildCache.store(archiveURL, forInputs: "other inputs").error).to(beNil())
+
+			expect(buildCache.archiveURL(forInputs: "inputs")) == buildCache.archiveURL(forInputs: "other inputs")
+		}
+
+		it("should forget archives which were changed") {
+			expect(buildCache.store(archiveURL, forInputs: "inputs").error).to(beNil())
+
+			let cachedURL = buildCache.archiveURL(forInputs: "inputs")!
+			expect { try "tampered with".write(to: cachedURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+			expect(buildCache.archiveURL(forInputs: "inputs")).to(beNil())
+			expect(FileManager.default.fileExists(atPath: buildCache.inputsURL(for: "inputs").path)) == false
+		}
+
+		describe("prune") {
+			let day: TimeInterval = 24 * 60 * 60
+			let now = Date()
+			let otherArchiveURL = temporaryURL.appendingPathComponent("Other.zip", isDirectory: false)
+
+			func markUsed(_ inputs: String, at date: Date) {
+				let objectURL = buildCache.archiveURL(forInputs: inputs)!
+				for url in [ objectURL, buildCache.inputsURL(for: inputs) ] {
+					expect { try FileManager.default.setAttributes([ .modificationDate: date ], ofItemAtPath: url.path) }.notTo(throwError())
+				}
+			}
+
+			beforeEach {
+				expect { try "other products".write(to: otherArchiveURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+				expect(buildCache.store(archiveURL, forInputs: "old inputs").error).to(beNil())
+				expect(buildCache.store(otherArchiveURL, forInputs: "new inputs").error).to(beNil())
+			}
+
+			it("should remove archives which haven't been used along with their inputs") {
+				let objectURL = buildCache.archiveURL(forInputs: "old inputs")
+				markUsed("old inputs", at: now.addingTimeInterval(-2 * day))
+
+				let removed = buildCache.prune(DerivedDataPolicy(maximumAge: day), now: now).collect().single()?.value
+				expect(removed?.map { $0.lastPathComponent }) == [ objectURL!.lastPathComponent ]
+				expect(FileManager.default.fileExists(atPath: buildCache.inputsURL(for: "old inputs").path)) == false
+				expect(buildCache.archiveURL(forInputs: "new inputs")).notTo(beNil())
+			}
+
+			it("should keep archives whose inputs have been used since") {
+				markUsed("old inputs", at: now.addingTimeInterval(-2 * day))
+				expect(buildCache.archiveURL(forInputs: "old inputs")).notTo(beNil())
+
+				let removed = buildCache.prune(DerivedDataPolicy(maximumAge: day), now: now).collect().single()?.value
+				expect(removed) == []
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+import Result
+@testable import CarthageKit
+
+class BuildSchedulerSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let estimatesURL = URL(fileURLWithPath: path, isDirectory: true).appendingPathComponent("BuildResources.json", isDirectory: false)
+		let gigabyte: UInt64 = 1 << 30
+
+		var availableMemory: UInt64 = 0
+		var estimates: BuildResourceEstimates!
+		var scheduler: BuildScheduler!
+
+		beforeEach {
+			availableMemory = 16 * gigabyte
+			estimates = BuildResourceEstimates(fileURL: estimatesURL)
+			let host = BuildScheduler.Host(
+				cpuBudget: 8,
+				memoryBudget: 12 * gigabyte,
+				availableMemory: { availableMemory },
+				loadAverage: { 0 }
+			)
+			scheduler = BuildScheduler(host: host, estimates: estimates)
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(atPath: path)
+		}
+
+		func build(_ key: String, limit: Int = 2, until finished: SignalProducer<(), NoError>) -> SignalProducer<Int, NoError> {
+			return scheduler.schedule(key: key, limit: limit) { jobs in
+				SignalProducer(value: jobs).concat(finished.then(SignalProducer<Int, NoError>.empty))
+			}
+		}
+
+		it("should split the CPU budget between concurrent builds") {
+			let (finished, finish) = Signal<(), NoError>.pipe()
+			var jobs: [Int] = []
+
+			build("A", until: SignalProducer(finished)).startWithValues { jobs.append($0) }
+			expect(jobs).toEventually(equal([ 4 ]))
+
+			build("B", until: SignalProducer(finished)).startWithValues { jobs.append($0) }
+			expect(jobs).toEventually(equal([ 4, 4 ]))
+
+			finish.sendCompleted()
+		}
+
+		it("should give a build which runs alone the whole CPU budget") {
+			let (finished, finish) = Signal<(), NoError>.pipe()
+			var jobs: [Int] = []
+
+			build("A", limit: 1, until: SignalProducer(finished)).startWithValues { jobs.append($0) }
+			expect(jobs).toEventually(equal([ 8 ]))
+
+			finish.sendCompleted()
+		}
+
+		it("should hold builds back until their memory fits into the budget") {
+			estimates.record(8 * gigabyte, forKey: "A")
+			estimates.record(8 * gigabyte, forKey: "B")
+
+			let (finishedA, finishA) = Signal<(), NoError>.pipe()
+			var started: [String] = []
+
+			build("A", until: SignalProducer(finishedA)).startWithValues { _ in started.append("A") }
+			build("B", until: .empty).startWithValues { _ in started.append("B") }
+
+			expect(started).toEventually(equal([ "A" ]))
+			expect(started).toNotEventually(contain("B"), timeout: 0.5)
+
+			finishA.sendCompleted()
+			expect(started).toEventually(equal([ "A", "B" ]))
+		}
+
+		it("should not run more builds at once than allowed") {
+			let (finishedA, finishA) = Signal<(), NoError>.pipe()
+			var started: [String] = []
+
+			build("A", limit: 1, until: SignalProducer(finishedA)).startWithValues { _ in started.append("A") }
+			build("B", limit: 1, until: .empty).startWithValues { _ in started.append("B") }
+
+			expect(started).toEventually(equal([ "A" ]))
+			expect(started).toNotEventually(contain("B"), timeout: 0.5)
+
+			finishA.sendCompleted()
+			expect(started).toEventually(equal([ "A", "B" ]))
+		}
+
+		it("should learn the memory builds take") {
+			expect(estimates["A"]).to(beNil())
+
+			estimates.record(4 * gigabyte, forKey: "A")
+			estimates.record(2 * gigabyte, forKey: "A")
+			expect(estimates["A"]) == 3 * gigabyte
+
+			expect(BuildResourceEstimates(fileURL: estimatesURL)["A"]) == 3 * gigabyte
+		}
+	}
+}
@@ -0,0 +1,112 @@
+import Foundation
+import Quick
+import Nimble
+@testable import CarthageKit
+
+class BuildSettingsCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let projectDirectoryURL = temporaryURL.appendingPathComponent("Project", isDirectory: true)
+		let projectFileURL = projectDirectoryURL.appendingPathComponent("Project.xcodeproj/project.pbxproj", isDirectory: false)
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: projectFileURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "// !$*UTF8*$!".write(to: projectFileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+			BuildSettingsCache.invalidateFingerprints()
+		}
+
+		it("should round-trip cached output") {
+			let cacheURL = temporaryURL.appendingPathComponent("BuildSettings", isDirectory: true)
+			expect(BuildSettingsCache.output(forKey: "abc", directoryURL: cacheURL)).to(beNil())
+
+			let output = "Build settings for action archive and target Foo:\n".data(using: .utf8)!
+			expect(BuildSettingsCache.store(output, forKey: "abc", directoryURL: cacheURL).error).to(beNil())
+			expect(BuildSettingsCache.output(forKey: "abc", directoryURL: cacheURL)) == output
+		}
+
+		it("should change the fingerprint when a project file changes") {
+			let original = BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)
+			expect(original).notTo(beNil())
+
+			expect { try "// !$*UTF8*$! changed".write(to: projectFileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+
+			expect(BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)) != original
+		}
+
+		it("should ignore files which don't affect build settings") {
+			let original = BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)
+
+			let sourceURL = projectDirectoryURL.appendingPathComponent("Source.swift", isDirectory: false)
+			expect { try "let x = 1".write(to: sourceURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+
+			expect(BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)) == original
+		}
+
+		it("should ignore other checkouts and symlinked directories") {
+			let otherProjectFileURL = temporaryURL.appendingPathComponent("Other/Other.xcodeproj/project.pbxproj", isDirectory: false)
+			let checkoutsURL = projectDirectoryURL.appendingPathComponent("Carthage/Checkouts", isDirectory: true)
+			let nestedProjectFileURL = checkoutsURL.appendingPathComponent("Nested/Nested.xcodeproj/project.pbxproj", isDirectory: false)
+			for url in [ otherProjectFileURL, nestedProjectFileURL ] {
+				expect { try FileManager.default.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+				expect { try "// !$*UTF8*$!".write(to: url, atomically: true, encoding: .utf8) }.notTo(throwError())
+			}
+			expect { try FileManager.default.createSymbolicLink(at: checkoutsURL.appendingPathComponent("Other"), withDestinationURL: otherProjectFileURL.deletingLastPathComponent().deletingLastPathComponent()) }.notTo(throwError())
+			expect { try FileManager.default.createSymbolicLink(at: projectDirectoryURL.appendingPathComponent("Other"), withDestinationURL: otherProjectFileURL.deletingLastPathComponent().deletingLastPathComponent()) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+			let original = BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)
+
+			for url in [ otherProjectFileURL, nestedProjectFileURL ] {
+				expect { try "// !$*UTF8*$! changed".write(to: url, atomically: true, encoding: .utf8) }.notTo(throwError())
+			}
+			BuildSettingsCache.invalidateFingerprints()
+
+			expect(BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)) == original
+		}
+
+		it("should change the fingerprint when a configuration file outside the project changes") {
+			let xcconfigURL = temporaryURL.appendingPathComponent("Shared/Base.xcconfig", isDirectory: false)
+			expect { try FileManager.default.createDirectory(at: xcconfigURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "EXCLUDED_ARCHS = arm64".write(to: xcconfigURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			let projectFile = "// !$*UTF8*$!\nA /* Base.xcconfig */ = {isa = PBXFileReference; path = ../Shared/Base.xcconfig; sourceTree = \"<group>\"; };"
+			expect { try projectFile.write(to: projectFileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			let original = BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)
+
+			expect { try "EXCLUDED_ARCHS = ".write(to: xcconfigURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+
+			expect(BuildSettingsCache.fingerprint(ofProjectFilesIn: projectDirectoryURL)) != original
+		}
+
+		it("should describe the inherited configuration file and the files it includes") {
+			let xcconfigURL = temporaryURL.appendingPathComponent("Global.xcconfig", isDirectory: false)
+			let includedURL = temporaryURL.appendingPathComponent("Included.xcconfig", isDirectory: false)
+			expect { try "#include \"Included.xcconfig\"\n#include? \"Optional.xcconfig\"".write(to: xcconfigURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			expect { try "EXCLUDED_ARCHS = arm64".write(to: includedURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+			let environment = [ "XCODE_XCCONFIG_FILE": xcconfigURL.path ]
+			let original = BuildSettingsCache.inheritedXCConfigFingerprint(environment: environment)
+			expect(original).notTo(beNil())
+			expect(BuildSettingsCache.inheritedXCConfigFingerprint(environment: [:])) != original
+			expect(BuildSettingsCache.inheritedXCConfigFingerprint(environment: environment.merging([ "ARCHS": "x86_64" ]) { $1 })) != original
+
+			expect { try "EXCLUDED_ARCHS = ".write(to: includedURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			expect(BuildSettingsCache.inheritedXCConfigFingerprint(environment: environment)) != original
+
+			expect { try FileManager.default.removeItem(at: includedURL) }.notTo(throwError())
+			expect(BuildSettingsCache.inheritedXCConfigFingerprint(environment: environment)).to(beNil())
+		}
+
+		it("should not fingerprint a missing directory") {
+			let missingURL = temporaryURL.appendingPathComponent("Missing", isDirectory: true)
+			expect(BuildSettingsCache.fingerprint(ofProjectFilesIn: missingURL)).to(beNil())
+		}
+	}
+}
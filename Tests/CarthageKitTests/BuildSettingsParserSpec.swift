@@ -0,0 +1,64 @@
+@testable import CarthageKit
+import Foundation
+import Nimble
+import Quick
+
+class BuildSettingsParserSpec: QuickSpec {
+	override func spec() {
+		let output: Data = {
+			let url = Bundle(for: BuildSettingsParserSpec.self).url(forResource: "BuildSettings/workspace", withExtension: "txt")!
+			return try! Data(contentsOf: url) // swiftlint:disable:this force_try
+		}()
+
+		func parse(_ chunks: [Data]) -> [(target: String, settings: [String: String])] {
+			var parser = BuildSettingsParser()
+			chunks.forEach { parser.consume($0) }
+			return parser.finish()
+		}
+
+		it("should parse the settings of each target") {
+			let targets = parse([ output ])
+
+			expect(targets.map { $0.target }) == [ "ReactiveCocoa-macOS", "ReactiveCocoaTests" ]
+			expect(targets[0].settings["WRAPPER_NAME"]) == "ReactiveCocoa.framework"
+			expect(targets[0].settings["GCC_PREPROCESSOR_DEFINITIONS"]) == "DEBUG=0 COCOAPODS=0"
+			expect(targets[0].settings["OTHER_SWIFT_FLAGS"]) == "-D CARTHAGE"
+			expect(targets[0].settings.count) == 14
+			expect(targets[1].settings["PRODUCT_TYPE"]) == "com.apple.product-type.bundle.unit-test"
+		}
+
+		it("should parse the same settings regardless of how the output is split") {
+			let expected = parse([ output ])
+
+			for chunkSize in [ 1, 7, 64, 1000 ] {
+				let chunks = stride(from: 0, to: output.count, by: chunkSize).map { start in
+					output.subdata(in: start..<min(start + chunkSize, output.count))
+				}
+				let targets = parse(chunks)
+
+				expect(targets.map { $0.target }) == expected.map { $0.target }
+				expect(targets.map { $0.settings }) == expected.map { $0.settings }
+			}
+		}
+
+		it("should parse output without a trailing newline") {
+			let targets = parse([ "Build settings for action build and target Foo:\n    ARCHS = arm64".data(using: .utf8)! ])
+
+			expect(targets.count) == 1
+			expect(targets.first?.settings) == [ "ARCHS": "arm64" ]
+		}
+
+		it("should not mistake settings for target headers") {
+			let targets = parse([ "Build settings for action build and target Foo:\n    INFOPLIST_KEY = Build settings for action build and target Bar:\n".data(using: .utf8)! ])
+
+			expect(targets.map { $0.target }) == [ "Foo" ]
+		}
+
+		it("should parse outputs of many targets") {
+			let manyTargets = (0..<200).reduce(into: Data()) { data, _ in data.append(output) }
+			let targets = parse([ manyTargets ])
+
+			expect(targets.count) == 400
+		}
+	}
+}
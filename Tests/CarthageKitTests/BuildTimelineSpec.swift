@@ -0,0 +1,76 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+import Result
+@testable import CarthageKit
+
+class BuildTimelineSpec: QuickSpec {
+	override func spec() {
+		let origin = Date(timeIntervalSinceReferenceDate: 0)
+
+		func span(_ phase: BuildPhase, _ dependency: String, from start: TimeInterval, to end: TimeInterval, sdk: String? = nil) -> BuildSpan {
+			return BuildSpan(
+				phase: phase,
+				dependency: dependency,
+				scheme: "\(dependency)-iOS",
+				sdk: sdk,
+				start: origin.addingTimeInterval(start),
+				end: origin.addingTimeInterval(end)
+			)
+		}
+
+		func json(_ result: Result<Data, CarthageError>) -> [String: Any]? {
+			return result.value.flatMap { try? JSONSerialization.jsonObject(with: $0) } as? [String: Any]
+		}
+
+		var timeline: BuildTimeline!
+
+		beforeEach {
+			timeline = BuildTimeline()
+			timeline.record(span(.settingsDiscovery, "Quick", from: 0, to: 1))
+			timeline.record(span(.archive, "Quick", from: 1, to: 4, sdk: "iphoneos"))
+			timeline.record(span(.compile, "Nimble", from: 1, to: 9, sdk: "iphonesimulator"))
+		}
+
+		it("should summarize the time spent per dependency, slowest first") {
+			let summary = json(timeline.summary())
+			expect(summary?["duration"] as? Double) == 9
+
+			let phases = summary?["phases"] as? [String: Double]
+			expect(phases?["compile"]) == 8
+			expect(phases?["archive"]) == 3
+			expect(phases?["settings-discovery"]) == 1
+
+			let dependencies = summary?["dependencies"] as? [[String: Any]]
+			expect(dependencies?.compactMap { $0["name"] as? String }) == [ "Nimble", "Quick" ]
+			expect(dependencies?.last?["duration"] as? Double) == 4
+
+			let spans = dependencies?.last?["spans"] as? [[String: Any]]
+			expect(spans?.compactMap { $0["phase"] as? String }) == [ "settings-discovery", "archive" ]
+			expect(spans?.last?["sdk"] as? String) == "iphoneos"
+			expect(spans?.last?["start"] as? Double) == 1
+		}
+
+		it("should put each dependency on its own track of the trace") {
+			let events = json(timeline.chromeTrace())?["traceEvents"] as? [[String: Any]]
+			let spans = events?.filter { $0["ph"] as? String == "X" }
+
+			expect(spans?.count) == 3
+			expect(spans?.compactMap { $0["name"] as? String }) == [ "settings-discovery", "archive", "compile" ]
+			expect(spans?.compactMap { $0["dur"] as? Int }) == [ 1_000_000, 3_000_000, 8_000_000 ]
+			expect(spans?[0]["tid"] as? Int) == spans?[1]["tid"] as? Int
+			expect(spans?[0]["tid"] as? Int) != spans?[2]["tid"] as? Int
+			expect(events?.filter { $0["ph"] as? String == "M" }.count) == 2
+		}
+
+		it("should record how long a producer runs") {
+			let producer = SignalProducer<Int, CarthageError>(value: 1)
+				.timed(.versionFile, in: timeline, dependency: "Result")
+
+			expect(producer.collect().single()?.value) == [ 1 ]
+			expect(timeline.spans.last?.phase) == .versionFile
+			expect(timeline.spans.last?.dependency) == "Result"
+		}
+	}
+}
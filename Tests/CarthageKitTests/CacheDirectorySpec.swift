@@ -0,0 +1,37 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+@testable import CarthageKit
+
+class CacheDirectorySpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let cacheDirectory = CacheDirectory(url: temporaryURL)
+		let day: TimeInterval = 24 * 60 * 60
+		let oldEntryURL = temporaryURL.appendingPathComponent("github.com/Carthage/old.json", isDirectory: false)
+		let recentEntryURL = temporaryURL.appendingPathComponent("recent.txt", isDirectory: false)
+
+		beforeEach {
+			for url in [ oldEntryURL, recentEntryURL ] {
+				expect { try FileManager.default.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+				expect { try "entry".write(to: url, atomically: true, encoding: .utf8) }.notTo(throwError())
+				expect { try FileManager.default.setAttributes([ .modificationDate: Date(timeIntervalSinceNow: -40 * day) ], ofItemAtPath: url.path) }.notTo(throwError())
+			}
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should remove entries which haven't been used for long enough, and the directories left empty") {
+			expect(CacheDirectory.contents(ofEntryAt: recentEntryURL)).notTo(beNil())
+
+			let removed = cacheDirectory.removeEntries(unusedFor: 30 * day).collect().single()?.value
+			expect(removed?.map { $0.lastPathComponent }) == [ "old.json" ]
+			expect(FileManager.default.fileExists(atPath: recentEntryURL.path)) == true
+			expect(FileManager.default.fileExists(atPath: temporaryURL.appendingPathComponent("github.com").path)) == false
+		}
+	}
+}
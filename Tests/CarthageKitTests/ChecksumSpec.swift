@@ -0,0 +1,89 @@
+import Foundation
+import Quick
+import Nimble
+@testable import CarthageKit
+
+class ChecksumSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let fileURL = temporaryURL.appendingPathComponent("MyFramework.framework.zip", isDirectory: false)
+		let hashesURL = temporaryURL.appendingPathComponent("BinaryHashes", isDirectory: true)
+		let digest = "c3ab8ff13720e8ad9047dd39466b3c8974e592c2fa383d4a3960714caef0c4f2"
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: temporaryURL, withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "foobar".write(to: fileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should compute the SHA-256 digest of a file") {
+			expect(sha256Digest(ofFileAt: fileURL).value) == digest
+		}
+
+		it("should compute the SHA-256 digest of an empty file") {
+			expect { try Data().write(to: fileURL) }.notTo(throwError())
+			expect(sha256Digest(ofFileAt: fileURL).value) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+		}
+
+		it("should compute the same digest from contents arriving in pieces") {
+			var digester = SHA256Digester()
+			digester.update(with: Data("foo".utf8))
+			digester.update(with: Data())
+			digester.update(with: Data("bar".utf8))
+			expect(digester.finalize()) == digest
+		}
+
+		it("should fail to compute the digest of a missing file") {
+			let missingURL = temporaryURL.appendingPathComponent("Missing.framework.zip", isDirectory: false)
+			expect(sha256Digest(ofFileAt: missingURL).error).notTo(beNil())
+		}
+
+		it("should record the digest of a cached binary") {
+			expect(recordCachedBinaryDigest(at: fileURL, expectedSHA256: digest.uppercased(), hashesDirectoryURL: hashesURL).error).to(beNil())
+			expect(BinaryHashCache.entry(forFileAt: fileURL, directoryURL: hashesURL)?.sha256) == digest
+			expect(verifyCachedBinary(at: fileURL, expectedSHA256: digest, hashesDirectoryURL: hashesURL)) == true
+		}
+
+		it("should record a digest computed while downloading without reading the file") {
+			let downloadedDigest = String(repeating: "a", count: 64)
+			expect(recordCachedBinaryDigest(at: fileURL, expectedSHA256: nil, sha256: downloadedDigest, hashesDirectoryURL: hashesURL).error).to(beNil())
+
+			let record = BinaryHashCache.entry(forFileAt: fileURL, directoryURL: hashesURL)
+			expect(record?.sha256) == downloadedDigest
+			expect(record?.attributes) == BinaryHashCache.attributes(ofFileAt: fileURL)
+		}
+
+		it("should reject a binary with an unexpected digest") {
+			let result = recordCachedBinaryDigest(at: fileURL, expectedSHA256: String(repeating: "0", count: 64), hashesDirectoryURL: hashesURL)
+			expect(result.error) == .checksumMismatch(fileURL, expected: String(repeating: "0", count: 64), actual: digest)
+			expect(FileManager.default.fileExists(atPath: fileURL.path)) == false
+		}
+
+		it("should reject a cached binary which changed after it was recorded") {
+			expect(recordCachedBinaryDigest(at: fileURL, expectedSHA256: nil, hashesDirectoryURL: hashesURL).error).to(beNil())
+			expect { try "foobaz".write(to: fileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+			expect(verifyCachedBinary(at: fileURL, expectedSHA256: nil, hashesDirectoryURL: hashesURL)) == false
+			expect(FileManager.default.fileExists(atPath: fileURL.path)) == false
+		}
+
+		it("should hash a cached binary again when asked to") {
+			let recordedDigest = String(repeating: "a", count: 64)
+			expect(recordCachedBinaryDigest(at: fileURL, expectedSHA256: nil, sha256: recordedDigest, hashesDirectoryURL: hashesURL).error).to(beNil())
+			expect(verifyCachedBinary(at: fileURL, expectedSHA256: nil, hashesDirectoryURL: hashesURL)) == true
+
+			expect(verifyCachedBinary(at: fileURL, expectedSHA256: nil, rehash: true, hashesDirectoryURL: hashesURL)) == false
+			expect(FileManager.default.fileExists(atPath: fileURL.path)) == false
+		}
+
+		it("should read the digest declared in a URL fragment") {
+			let url = URL(string: "https://my.domain.com/release/1.0.0/MyFramework.framework.zip#sha256=\(digest)")!
+			expect(url.declaredSHA256) == digest
+			expect(URL(string: "https://my.domain.com/release/1.0.0/MyFramework.framework.zip")!.declaredSHA256).to(beNil())
+		}
+	}
+}
@@ -0,0 +1,97 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+@testable import CarthageKit
+
+class DerivedDataStoreSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let store = DerivedDataStore(directoryURL: temporaryURL)
+		let now = Date()
+		let day: TimeInterval = 24 * 60 * 60
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		@discardableResult
+		func makeEntry(_ dependencyName: String, commitish: String, lastUsed: Date) -> URL {
+			let url = store.derivedDataURL(xcodeVersion: "12.4_12D4e", dependencyName: dependencyName, commitish: commitish)
+			let fileURL = url.appendingPathComponent("Build/Intermediates.noindex/\(dependencyName).o", isDirectory: false)
+			expect { try FileManager.default.createDirectory(at: fileURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try Data(count: 64 * 1024).write(to: fileURL) }.notTo(throwError())
+			expect(store.recordUse(of: url, measuringSize: true, at: lastUsed).error).to(beNil())
+			return url
+		}
+
+		it("should list entries with the time they were last used and their size") {
+			let url = makeEntry("Alamofire", commitish: "5.4.1", lastUsed: now.addingTimeInterval(-day))
+
+			let entries = store.entries()
+			expect(entries.map { $0.url.standardizedFileURL }) == [ url.standardizedFileURL ]
+			expect(entries.first?.lastUsed.timeIntervalSince1970).to(beCloseTo(now.addingTimeInterval(-day).timeIntervalSince1970, within: 1))
+			expect(entries.first?.size).to(beGreaterThanOrEqualTo(64 * 1024))
+		}
+
+		it("should keep revisions with slashes within one entry") {
+			makeEntry("Alamofire", commitish: "feature/uploads", lastUsed: now)
+
+			expect(store.entries().map { $0.url.lastPathComponent }) == [ "feature" ]
+		}
+
+		it("should remove entries which have gone unused for too long") {
+			let old = makeEntry("Alamofire", commitish: "5.4.0", lastUsed: now.addingTimeInterval(-40 * day))
+			let recent = makeEntry("Alamofire", commitish: "5.4.1", lastUsed: now.addingTimeInterval(-2 * day))
+
+			let removed = store.prune(DerivedDataPolicy(maximumAge: 30 * day), now: now).collect().single()?.value
+			expect(removed?.map { $0.url.lastPathComponent }) == [ "5.4.0" ]
+			expect(FileManager.default.fileExists(atPath: old.path)) == false
+			expect(FileManager.default.fileExists(atPath: recent.path)) == true
+		}
+
+		it("should remove the least recently used entries until the rest fit") {
+			makeEntry("Alamofire", commitish: "5.4.0", lastUsed: now.addingTimeInterval(-3 * day))
+			makeEntry("Nimble", commitish: "9.0.0", lastUsed: now.addingTimeInterval(-2 * day))
+			makeEntry("Quick", commitish: "3.1.0", lastUsed: now.addingTimeInterval(-1 * day))
+
+			let size = store.entries().first!.size
+			let removed = store.prune(DerivedDataPolicy(maximumSize: size * 2), now: now).collect().single()?.value
+			expect(removed?.map { $0.url.lastPathComponent }) == [ "5.4.0" ]
+
+			// The directory of a dependency without any entries left goes too.
+			expect(FileManager.default.fileExists(atPath: temporaryURL.appendingPathComponent("12.4_12D4e/Alamofire").path)) == false
+		}
+
+		it("should leave alone derived data which Carthage didn't build into") {
+			let foreignURL = temporaryURL.appendingPathComponent("Xcode/MyApp-abcdef/Build", isDirectory: true)
+			expect { try FileManager.default.createDirectory(at: foreignURL, withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try FileManager.default.setAttributes([ .modificationDate: now.addingTimeInterval(-40 * day) ], ofItemAtPath: foreignURL.path) }.notTo(throwError())
+			makeEntry("Alamofire", commitish: "5.4.0", lastUsed: now.addingTimeInterval(-40 * day))
+
+			let removed = store.prune(DerivedDataPolicy(maximumAge: 30 * day), now: now).collect().single()?.value
+			expect(removed?.map { $0.url.lastPathComponent }) == [ "5.4.0" ]
+			expect(FileManager.default.fileExists(atPath: foreignURL.path)) == true
+		}
+
+		it("should adopt derived data built before uses were recorded in a folder of its own") {
+			let ownStore = DerivedDataStore(directoryURL: temporaryURL, adoptsUnrecordedEntries: true)
+			let legacyURL = ownStore.derivedDataURL(xcodeVersion: "12.4_12D4e", dependencyName: "Alamofire", commitish: "5.3.0")
+			expect { try FileManager.default.createDirectory(at: legacyURL, withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try FileManager.default.setAttributes([ .modificationDate: now.addingTimeInterval(-40 * day) ], ofItemAtPath: legacyURL.path) }.notTo(throwError())
+
+			expect(store.entries()).to(beEmpty())
+
+			let removed = ownStore.prune(DerivedDataPolicy(maximumAge: 30 * day), now: now).collect().single()?.value
+			expect(removed?.map { $0.url.lastPathComponent }) == [ "5.3.0" ]
+		}
+
+		it("should not remove entries which have just been used") {
+			makeEntry("Alamofire", commitish: "5.4.1", lastUsed: now)
+
+			let removed = store.prune(DerivedDataPolicy(maximumSize: 0), now: now).collect().single()?.value
+			expect(removed?.isEmpty) == true
+		}
+	}
+}
@@ -1,6 +1,8 @@
 import Foundation
 import Quick
 import Nimble
+import ReactiveSwift
+@testable import CarthageKit
 
 class FrameworkExtensionsSpec: QuickSpec {
 	override func spec() {
@@ -42,5 +44,99 @@ class FrameworkExtensionsSpec: QuickSpec {
 				}
 			}
 		}
+
+		describe("retry(upTo:backingOffFrom:on:where:)") {
+			struct TestError: Error, Equatable {
+				let isRetryable: Bool
+			}
+
+			var scheduler: TestScheduler!
+			var attempts = 0
+			var values: [Int] = []
+			var error: TestError?
+
+			beforeEach {
+				scheduler = TestScheduler()
+				attempts = 0
+				values = []
+				error = nil
+			}
+
+			/// Starts a producer which fails with the given error until it has
+			/// been attempted `succeedingAfter` times.
+			func start(failingWith failure: TestError, succeedingAfter successfulAttempt: Int = .max) {
+				SignalProducer<Int, TestError> { observer, _ in
+						attempts += 1
+						if attempts == successfulAttempt {
+							observer.send(value: attempts)
+							observer.sendCompleted()
+						} else {
+							observer.send(error: failure)
+						}
+					}
+					.retry(upTo: 3, backingOffFrom: 1, on: scheduler, where: { $0.isRetryable })
+					.start { event in
+						switch event {
+						case let .value(value):
+							values.append(value)
+
+						case let .failed(failure):
+							error = failure
+
+						default:
+							break
+						}
+					}
+			}
+
+			it("should retry up to the given number of times") {
+				start(failingWith: TestError(isRetryable: true))
+				scheduler.run()
+
+				expect(attempts) == 4
+				expect(error) == TestError(isRetryable: true)
+			}
+
+			it("should stop retrying once the producer succeeds") {
+				start(failingWith: TestError(isRetryable: true), succeedingAfter: 2)
+				scheduler.run()
+
+				expect(attempts) == 2
+				expect(values) == [ 2 ]
+				expect(error).to(beNil())
+			}
+
+			it("should fail immediately with an error which isn't retried") {
+				start(failingWith: TestError(isRetryable: false))
+
+				expect(attempts) == 1
+				expect(error) == TestError(isRetryable: false)
+
+				scheduler.run()
+				expect(attempts) == 1
+			}
+
+			it("should double the delay before each retry") {
+				start(failingWith: TestError(isRetryable: true))
+				expect(attempts) == 1
+
+				scheduler.advance(by: .milliseconds(999))
+				expect(attempts) == 1
+				scheduler.advance(by: .milliseconds(1))
+				expect(attempts) == 2
+
+				scheduler.advance(by: .milliseconds(1_999))
+				expect(attempts) == 2
+				scheduler.advance(by: .milliseconds(1))
+				expect(attempts) == 3
+
+				scheduler.advance(by: .milliseconds(3_999))
+				expect(attempts) == 3
+				expect(error).to(beNil())
+				scheduler.advance(by: .milliseconds(1))
+				expect(attempts) == 4
+				expect(error) == TestError(isRetryable: true)
+			}
+		}
 	}
 }
@@ -0,0 +1,234 @@
+@testable import CarthageKit
+import Foundation
+import MachO
+import Nimble
+import Quick
+import Result
+
+/// Builds a 64-bit Mach-O header, followed by the given load commands.
+private func makeMachObject(cpuType: UInt32, cpuSubtype: UInt32, fileType: UInt32 = UInt32(MH_DYLIB), loadCommands: [Data] = []) -> Data {
+	func littleEndian(_ values: [UInt32]) -> Data {
+		return Data(values.flatMap { value in (0..<4).map { UInt8(truncatingIfNeeded: value >> ($0 * 8)) } })
+	}
+
+	let commands = loadCommands.reduce(Data(), +)
+	return littleEndian([ MH_MAGIC_64, cpuType, cpuSubtype, fileType, UInt32(loadCommands.count), UInt32(commands.count), 0, 0 ]) + commands
+}
+
+/// Builds an LC_SEGMENT_64 load command for a segment at the given address.
+private func makeSegmentCommand(address: UInt64) -> Data {
+	let header: [UInt8] = [ 0x19, 0, 0, 0, 72, 0, 0, 0 ]
+	let addressBytes = (0..<8).map { UInt8(truncatingIfNeeded: address >> ($0 * 8)) }
+	return Data(header) + Data(count: 16) + Data(addressBytes) + Data(count: 40)
+}
+
+/// Builds a 64-bit Mach-O object with the given sections in its __DWARF
+/// segment.
+private func makeDebugInformationObject(sections: [(name: String, contents: Data)]) -> Data {
+	func littleEndian<T: FixedWidthInteger>(_ value: T) -> Data {
+		return Data((0..<(T.bitWidth / 8)).map { UInt8(truncatingIfNeeded: value >> ($0 * 8)) })
+	}
+	func name(_ string: String) -> Data {
+		return Data(string.utf8) + Data(count: 16 - string.utf8.count)
+	}
+
+	let commandSize = 72 + sections.count * 80
+	var offset = 32 + commandSize
+	var command = littleEndian(UInt32(LC_SEGMENT_64)) + littleEndian(UInt32(commandSize)) + name("__DWARF")
+	command += Data(count: 40) + littleEndian(UInt32(sections.count)) + littleEndian(UInt32(0))
+	for section in sections {
+		command += name(section.name) + name("__DWARF") + littleEndian(UInt64(0)) + littleEndian(UInt64(section.contents.count))
+		command += littleEndian(UInt32(offset)) + Data(count: 28)
+		offset += section.contents.count
+	}
+
+	let header = [ MH_MAGIC_64, 0x0100_000c, 0, UInt32(MH_DSYM), 1, UInt32(commandSize), 0, 0 ].reduce(Data()) { $0 + littleEndian($1) }
+	return sections.reduce(header + command) { $0 + $1.contents }
+}
+
+/// Builds a universal file of the given slices, aligned to 2^12 bytes.
+private func makeUniversalFile(_ slices: [(cpuType: UInt32, cpuSubtype: UInt32, contents: Data)]) -> Data {
+	func bigEndian(_ values: [UInt32]) -> Data {
+		return Data(values.flatMap { value in (0..<4).reversed().map { UInt8(truncatingIfNeeded: value >> ($0 * 8)) } })
+	}
+
+	var header = bigEndian([ UInt32(FAT_MAGIC), UInt32(slices.count) ])
+	var contents = Data()
+	var offset = 4096
+	for slice in slices {
+		header += bigEndian([ slice.cpuType, slice.cpuSubtype, UInt32(offset), UInt32(slice.contents.count), 12 ])
+		contents += slice.contents + Data(count: (4096 - slice.contents.count % 4096) % 4096)
+		offset += slice.contents.count + (4096 - slice.contents.count % 4096) % 4096
+	}
+
+	return header + Data(count: 4096 - header.count) + contents
+}
+
+class MachOFileSpec: QuickSpec {
+	override func spec() {
+		let x86_64: UInt32 = 0x0100_0007
+		let arm64: UInt32 = 0x0100_000c
+
+		it("should read the slices and static library members of a universal file") {
+			let frameworkURL = Bundle(for: type(of: self)).url(forResource: "Alamofire.framework", withExtension: nil)!
+			let file = MachOFile.read(at: frameworkURL.appendingPathComponent("Alamofire")).value
+
+			expect(file?.isUniversal) == true
+			expect(file?.architectures) == [ "armv7", "arm64" ]
+			expect(file?.slices.map { $0.objects.count }) == [ 18, 18 ]
+			expect(file?.slices.flatMap { $0.objects }.allSatisfy { $0.header.fileType == UInt32(MH_OBJECT) }) == true
+		}
+
+		it("should read the header and load commands of a thin file") {
+			let uuidCommand = Data([ 0x1b, 0, 0, 0, 24, 0, 0, 0 ]) + Data(count: 16)
+			let data = makeMachObject(cpuType: x86_64, cpuSubtype: 3, loadCommands: [ uuidCommand ])
+			let file = MachOFile.parse(data).value
+
+			expect(file?.isUniversal) == false
+			expect(file?.architectures) == [ "x86_64" ]
+			expect(file?.slices.first?.objects.first?.header.fileType) == UInt32(MH_DYLIB)
+			expect(file?.slices.first?.objects.first?.loadCommands.map { $0.command }) == [ 0x1b ]
+			expect(file?.slices.first?.objects.first?.loadCommands.first?.range) == 32..<56
+		}
+
+		it("should read the UUID of each architecture") {
+			let armUUID = UUID(uuidString: "B6A5A2E5-5C2C-3F7E-9C57-0A2F3E5C1D01")!
+			let intelUUID = UUID(uuidString: "0E9F6A3B-77D4-3C0B-A4B8-64C0F1D5E202")!
+			func uuidCommand(_ uuid: UUID) -> Data {
+				return Data([ 0x1b, 0, 0, 0, 24, 0, 0, 0 ]) + withUnsafeBytes(of: uuid.uuid) { Data($0) }
+			}
+
+			let data = makeUniversalFile([
+				(x86_64, 3, makeMachObject(cpuType: x86_64, cpuSubtype: 3, loadCommands: [ uuidCommand(intelUUID) ])),
+				(arm64, 0, makeMachObject(cpuType: arm64, cpuSubtype: 0, loadCommands: [ uuidCommand(armUUID) ])),
+			])
+
+			expect(MachOFile.parse(data).value?.uuids) == [ armUUID, intelUUID ]
+		}
+
+		it("should not find UUIDs in static libraries") {
+			let frameworkURL = Bundle(for: type(of: self)).url(forResource: "Alamofire.framework", withExtension: nil)!
+
+			expect(MachOFile.read(at: frameworkURL.appendingPathComponent("Alamofire")).value?.uuids) == []
+		}
+
+		it("should name architectures regardless of capability bits") {
+			let data = makeUniversalFile([
+				(x86_64, 3, makeMachObject(cpuType: x86_64, cpuSubtype: 3)),
+				(arm64, 0x8000_0002, makeMachObject(cpuType: arm64, cpuSubtype: 0x8000_0002)),
+			])
+
+			expect(MachOFile.parse(data).value?.architectures) == [ "x86_64", "arm64e" ]
+		}
+
+		it("should remove architectures, keeping the alignment of the other slices") {
+			let intel = makeMachObject(cpuType: x86_64, cpuSubtype: 3, loadCommands: [ Data([ 0x1b, 0, 0, 0, 24, 0, 0, 0 ]) + Data(count: 16) ])
+			let arm = makeMachObject(cpuType: arm64, cpuSubtype: 0)
+			let data = makeUniversalFile([ (x86_64, 3, intel), (arm64, 0, arm) ])
+
+			let thinned = MachOFile.parse(data).value?.removingArchitectures([ "x86_64" ]).value
+			let file = thinned.flatMap { MachOFile.parse($0).value }
+
+			expect(file?.isUniversal) == true
+			expect(file?.architectures) == [ "arm64" ]
+			expect(file?.slices.first?.alignment) == 12
+			expect(file?.slices.first?.range) == 4096..<(4096 + arm.count)
+			expect(file.map { $0.data[$0.slices[0].range] }) == arm
+		}
+
+		it("should not remove every architecture, nor that of a thin file") {
+			let arm = makeMachObject(cpuType: arm64, cpuSubtype: 0)
+			let universalFile = MachOFile.parse(makeUniversalFile([ (arm64, 0, arm) ])).value
+			let thinFile = MachOFile.parse(arm).value
+
+			expect(universalFile?.removingArchitectures([ "arm64" ]).error).notTo(beNil())
+			expect(thinFile?.removingArchitectures([ "arm64" ]).error).notTo(beNil())
+			expect(thinFile?.removingArchitectures([ "armv7" ]).value) == arm
+		}
+
+		it("should merge slices like lipo does") {
+			let frameworkURL = Bundle(for: type(of: self)).url(forResource: "Alamofire.framework", withExtension: nil)!
+			guard let universalFile = MachOFile.read(at: frameworkURL.appendingPathComponent("Alamofire")).value else {
+				fail("Could not read the fixture")
+				return
+			}
+
+			// The fixture was created by lipo, from thin static libraries.
+			let thinFiles = universalFile.slices.reversed().compactMap { MachOFile.parse(universalFile.data[$0.range]).value }
+			expect(thinFiles.map { $0.slices[0].alignment }) == [ 3, 2 ]
+			expect(MachOFile.merging(thinFiles).value) == universalFile.data
+		}
+
+		it("should merge dynamic libraries like lipo does") {
+			let binaryURL = Bundle(for: type(of: self)).url(forResource: "CleanupTest/RemoveDynamic/Carthage/Build/iOS/TestFramework.framework/TestFramework", withExtension: nil)!
+			guard let universalFile = MachOFile.read(at: binaryURL).value else {
+				fail("Could not read the fixture")
+				return
+			}
+
+			// The fixture was created by lipo, from the device and then the
+			// simulator frameworks.
+			expect(universalFile.architectures) == [ "i386", "x86_64", "armv7", "arm64" ]
+			let slices = Dictionary(uniqueKeysWithValues: universalFile.slices.map { ($0.architecture, $0) })
+			let thinFiles = [ "armv7", "arm64", "i386", "x86_64" ].compactMap { architecture in
+				slices[architecture].flatMap { MachOFile.parse(universalFile.data[$0.range]).value }
+			}
+			expect(thinFiles.map { $0.slices[0].alignment }) == [ 14, 14, 12, 12 ]
+			expect(MachOFile.merging(thinFiles).value) == universalFile.data
+		}
+
+		it("should align merged dynamic libraries to their segments, with arm64 last") {
+			let arm = makeMachObject(cpuType: arm64, cpuSubtype: 0, loadCommands: [ makeSegmentCommand(address: 0), makeSegmentCommand(address: 0xc000) ])
+			let intel = makeMachObject(cpuType: x86_64, cpuSubtype: 3, loadCommands: [ makeSegmentCommand(address: 0x3000) ])
+			let files = [ arm, intel ].compactMap { MachOFile.parse($0).value }
+
+			let merged = MachOFile.merging(files).value.flatMap { MachOFile.parse($0).value }
+			expect(merged?.architectures) == [ "x86_64", "arm64" ]
+			expect(merged?.slices.map { $0.alignment }) == [ 12, 14 ]
+			expect(merged?.slices.map { $0.range.lowerBound }) == [ 4096, 16384 ]
+		}
+
+		it("should not merge slices of the same architecture") {
+			let files = [ makeMachObject(cpuType: arm64, cpuSubtype: 0), makeMachObject(cpuType: arm64, cpuSubtype: 0) ]
+				.compactMap { MachOFile.parse($0).value }
+
+			expect(MachOFile.merging(files).error).notTo(beNil())
+		}
+
+		it("should read the producers of compile units") {
+			let clangProducer = "Apple clang version 12.0.0 (clang-1200.0.32.28)"
+			let swiftProducer = "Apple Swift version 5.3.2 (swiftlang-1200.0.45 clang-1200.0.32.28) -emit-object"
+
+			// A DWARF 4 unit with an inline producer, and a DWARF 5 one whose
+			// producer is in __debug_str.
+			let debugAbbrev = Data([
+				1, 0x11, 0, 0x25, 0x08, 0x13, 0x05, 0, 0,
+				2, 0x11, 0, 0x13, 0x0b, 0x25, 0x0e, 0, 0,
+				0,
+			])
+			let firstUnit = Data([ 4, 0, 0, 0, 0, 0, 8, 1 ]) + Data(clangProducer.utf8) + Data([ 0, 0x0c, 0 ])
+			let secondUnit = Data([ 5, 0, 1, 8, 0, 0, 0, 0, 2, 0x1e, 0, 0, 0, 0 ])
+			let debugInfo = [ firstUnit, secondUnit ].reduce(Data()) { info, unit in
+				info + Data([ UInt8(unit.count), 0, 0, 0 ]) + unit
+			}
+
+			let data = makeDebugInformationObject(sections: [
+				("__debug_abbrev", debugAbbrev),
+				("__debug_info", debugInfo),
+				("__debug_str", Data(swiftProducer.utf8) + Data([ 0 ])),
+			])
+			let file = MachOFile.parse(data).value
+
+			expect { try file?.firstCompileUnitProducer(where: { _ in true }) } == clangProducer
+			expect { try file?.firstCompileUnitProducer(where: { $0.hasPrefix("Apple Swift") }) } == swiftProducer
+			expect { try file?.firstCompileUnitProducer(where: { _ in false }) }.to(beNil())
+		}
+
+		it("should fail on truncated files") {
+			let data = makeMachObject(cpuType: arm64, cpuSubtype: 0, loadCommands: [ Data([ 0x1b, 0, 0, 0, 24, 0, 0, 0 ]) + Data(count: 16) ])
+
+			expect(MachOFile.parse(data.prefix(40)).error).notTo(beNil())
+			expect(MachOFile.parse(Data("not a Mach-O file".utf8)).error).notTo(beNil())
+		}
+	}
+}
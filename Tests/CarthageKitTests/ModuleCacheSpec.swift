@@ -0,0 +1,53 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+@testable import CarthageKit
+
+class ModuleCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let moduleCache = ModuleCache(directoryURL: temporaryURL)
+		let day: TimeInterval = 24 * 60 * 60
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should key caches by toolchain") {
+			expect(moduleCache.url(forToolchain: "com.apple.dt.toolchain.XcodeDefault")) != moduleCache.url(forToolchain: "org.swift.50320201211a")
+		}
+
+		it("should only remove caches which haven't been used for long enough") {
+			let oldCacheURL = temporaryURL.appendingPathComponent("old", isDirectory: true)
+			let recentCacheURL = temporaryURL.appendingPathComponent("recent", isDirectory: true)
+			expect(SignalProducer<(), CarthageError>.empty.usingModuleCache(at: oldCacheURL).wait().error).to(beNil())
+			expect(SignalProducer<(), CarthageError>.empty.usingModuleCache(at: recentCacheURL).wait().error).to(beNil())
+
+			let oldLockFileURL = ModuleCache.lockFileURL(forCacheAt: oldCacheURL)
+			expect { try FileManager.default.setAttributes([ .modificationDate: Date(timeIntervalSinceNow: -40 * day) ], ofItemAtPath: oldLockFileURL.path) }.notTo(throwError())
+
+			let removed = moduleCache.removeCaches(unusedFor: 30 * day).collect().single()?.value
+			expect(removed?.map { $0.lastPathComponent }) == [ "old" ]
+			expect(FileManager.default.fileExists(atPath: recentCacheURL.path)) == true
+
+			// Builds may still be waiting on the lock of the removed cache.
+			expect(FileManager.default.fileExists(atPath: oldLockFileURL.path)) == true
+		}
+
+		it("should not remove caches which are in use") {
+			let cacheURL = temporaryURL.appendingPathComponent("cache", isDirectory: true)
+			let (signal, observer) = Signal<(), CarthageError>.pipe()
+			let disposable = SignalProducer(signal).usingModuleCache(at: cacheURL).start()
+
+			let lockFileURL = ModuleCache.lockFileURL(forCacheAt: cacheURL)
+			expect { try FileManager.default.setAttributes([ .modificationDate: Date(timeIntervalSinceNow: -40 * day) ], ofItemAtPath: lockFileURL.path) }.notTo(throwError())
+
+			expect(moduleCache.removeCaches(unusedFor: 30 * day).collect().single()?.value?.isEmpty) == true
+
+			observer.sendCompleted()
+			disposable.dispose()
+		}
+	}
+}
@@ -0,0 +1,104 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveSwift
+@testable import CarthageKit
+
+class ProducerQueueSpec: QuickSpec {
+	override func spec() {
+		describe("mergeInDependencyOrder") {
+			struct TestError: Error, Equatable {}
+
+			var observers: Atomic<[String: Signal<String, TestError>.Observer]>!
+			var startedNodes: Atomic<[String]>!
+			var endedNodes: Atomic<[String]>!
+			var completed: Atomic<Bool>!
+			var error: Atomic<TestError?>!
+
+			beforeEach {
+				observers = Atomic([:])
+				startedNodes = Atomic([])
+				endedNodes = Atomic([])
+				completed = Atomic(false)
+				error = Atomic(nil)
+			}
+
+			/// Merges a producer for each of the given nodes, which only
+			/// terminates once the spec sends it an event through `observers`.
+			func start(_ nodes: [String], dependencies: [String: Set<String>] = [:], limit: Int) {
+				mergeInDependencyOrder(nodes, dependencies: { dependencies[$0] ?? [] }, limit: limit) { node in
+						SignalProducer<String, TestError> { observer, lifetime in
+							lifetime.observeEnded {
+								endedNodes.modify { $0.append(node) }
+							}
+							observers.modify { $0[node] = observer }
+							startedNodes.modify { $0.append(node) }
+						}
+					}
+					.start { event in
+						switch event {
+						case .completed:
+							completed.value = true
+
+						case let .failed(failure):
+							error.value = failure
+
+						default:
+							break
+						}
+					}
+			}
+
+			func finish(_ node: String) {
+				let observer = observers.value[node]
+				observer?.send(value: node)
+				observer?.sendCompleted()
+			}
+
+			it("should start a node only after the nodes it depends on have completed") {
+				start([ "c", "b", "a" ], dependencies: [ "b": [ "a" ], "c": [ "a", "b" ] ], limit: 3)
+
+				expect(startedNodes.value).toEventually(equal([ "a" ]))
+				expect(startedNodes.value) == [ "a" ]
+
+				finish("a")
+				expect(startedNodes.value).toEventually(equal([ "a", "b" ]))
+
+				finish("b")
+				expect(startedNodes.value).toEventually(equal([ "a", "b", "c" ]))
+
+				finish("c")
+				expect(completed.value).toEventually(beTrue())
+				expect(error.value).to(beNil())
+			}
+
+			it("should run independent nodes concurrently up to the limit") {
+				start([ "a", "b", "c" ], limit: 2)
+
+				expect(startedNodes.value.count).toEventually(equal(2))
+				expect(endedNodes.value).to(beEmpty())
+				expect(startedNodes.value.count) == 2
+
+				finish(startedNodes.value[0])
+				expect(startedNodes.value.count).toEventually(equal(3))
+
+				for node in startedNodes.value.dropFirst() {
+					finish(node)
+				}
+				expect(completed.value).toEventually(beTrue())
+			}
+
+			it("should interrupt the other nodes when one fails") {
+				start([ "a", "b", "c" ], dependencies: [ "b": [ "a" ] ], limit: 2)
+
+				expect(Set(startedNodes.value)).toEventually(equal([ "a", "c" ]))
+
+				observers.value["a"]?.send(error: TestError())
+				expect(error.value).toEventually(equal(TestError()))
+				expect(endedNodes.value).toEventually(contain("c"))
+				expect(startedNodes.value).notTo(contain("b"))
+				expect(completed.value) == false
+			}
+		}
+	}
+}
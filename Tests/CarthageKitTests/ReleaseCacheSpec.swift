@@ -0,0 +1,54 @@
+import Foundation
+import Quick
+import Nimble
+import Tentacle
+@testable import CarthageKit
+
+class ReleaseCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let repository = Repository(owner: "ReactiveCocoa", name: "ReactiveSwift")
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should round-trip a cached release") {
+			let asset = CachedRelease.Asset(id: "1234", name: "ReactiveSwift.framework.zip", contentType: "application/zip")
+			let release = CachedRelease(tag: "v2.3.1", name: nil, isDraft: false, assets: [ asset ])
+			let entry = ReleaseCacheEntry(release: release, etag: "\"abc\"", date: Date())
+
+			let result = ReleaseCache.store(entry, for: repository, tag: "v2.3.1", server: .dotCom, directoryURL: temporaryURL)
+			expect(result.error).to(beNil())
+
+			let cached = ReleaseCache.entry(for: repository, tag: "v2.3.1", server: .dotCom, directoryURL: temporaryURL)
+			expect(cached?.release) == release
+			expect(cached?.etag) == "\"abc\""
+			expect(cached?.release?.nameWithFallback) == "v2.3.1"
+			expect(cached?.isFresh) == true
+		}
+
+		it("should keep tags containing slashes in a single file") {
+			let url = ReleaseCache.fileURL(for: repository, tag: "release/1.0", server: .dotCom, directoryURL: temporaryURL)
+			expect(url.lastPathComponent) == "release%2F1.0.json"
+			expect(url.deletingLastPathComponent().lastPathComponent) == "ReactiveSwift"
+		}
+
+		it("should expire negative results") {
+			let stale = ReleaseCacheEntry(release: nil, etag: nil, date: Date(timeIntervalSinceNow: -(ReleaseCache.negativeResultTimeToLive + 1)))
+			expect(stale.isFresh) == false
+
+			let recent = ReleaseCacheEntry(release: nil, etag: nil, date: Date())
+			expect(recent.isFresh) == true
+		}
+
+		it("should not use a cache entry for a different tag") {
+			let entry = ReleaseCacheEntry(release: nil, etag: nil, date: Date())
+			ReleaseCache.store(entry, for: repository, tag: "v1.0", server: .dotCom, directoryURL: temporaryURL)
+
+			expect(ReleaseCache.entry(for: repository, tag: "v1.0", server: .dotCom, directoryURL: temporaryURL)).notTo(beNil())
+			expect(ReleaseCache.entry(for: repository, tag: "v1.1", server: .dotCom, directoryURL: temporaryURL)).to(beNil())
+		}
+	}
+}
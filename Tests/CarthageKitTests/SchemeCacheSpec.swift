@@ -0,0 +1,66 @@
+import Foundation
+import Quick
+import Nimble
+import XCDBLD
+@testable import CarthageKit
+
+class SchemeCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+
+		let projectDirectoryURL = temporaryURL.appendingPathComponent("Project", isDirectory: true)
+		let projectFileURL = projectDirectoryURL.appendingPathComponent("Project.xcodeproj/project.pbxproj", isDirectory: false)
+		let xcconfigURL = temporaryURL.appendingPathComponent("Global.xcconfig", isDirectory: false)
+		let environment = [ "XCODE_XCCONFIG_FILE": xcconfigURL.path ]
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: projectFileURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "// !$*UTF8*$!".write(to: projectFileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			expect { try "EXCLUDED_ARCHS = arm64".write(to: xcconfigURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+			BuildSettingsCache.invalidateFingerprints()
+		}
+
+		func key() -> String? {
+			return SchemeCache.key(for: projectDirectoryURL, configuration: "Release", platforms: nil, environment: environment)
+		}
+
+		it("should round-trip schemes and the projects they are built from") {
+			let workspace = ProjectLocator.workspace(URL(fileURLWithPath: "/tmp/ReactiveCocoa/ReactiveCocoa.xcworkspace", isDirectory: true))
+			let project = ProjectLocator.projectFile(URL(fileURLWithPath: "/tmp/ReactiveCocoa/ReactiveCocoa.xcodeproj", isDirectory: true))
+			let schemes = [ (Scheme("ReactiveCocoa-macOS"), workspace), (Scheme("ReactiveCocoa-iOS"), project) ]
+
+			expect(SchemeCache.schemes(forKey: "abc", directoryURL: temporaryURL)).to(beNil())
+			expect(SchemeCache.store(schemes, forKey: "abc", directoryURL: temporaryURL).error).to(beNil())
+
+			let cached = SchemeCache.schemes(forKey: "abc", directoryURL: temporaryURL)
+			expect(cached?.map { $0.0 }) == schemes.map { $0.0 }
+			expect(cached?.map { $0.1 }) == schemes.map { $0.1 }
+		}
+
+		it("should invalidate schemes when a project file changes") {
+			let original = key()
+			expect(original).notTo(beNil())
+
+			expect { try "// !$*UTF8*$! changed".write(to: projectFileURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			BuildSettingsCache.invalidateFingerprints()
+
+			expect(key()) != original
+		}
+
+		it("should invalidate schemes when the inherited configuration file changes") {
+			let original = key()
+			expect(original).notTo(beNil())
+
+			expect { try "EXCLUDED_ARCHS = ".write(to: xcconfigURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+			expect(key()) != original
+			expect(SchemeCache.key(for: projectDirectoryURL, configuration: "Release", platforms: nil, environment: [:])) != key()
+		}
+	}
+}
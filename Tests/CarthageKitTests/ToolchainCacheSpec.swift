@@ -0,0 +1,56 @@
+import Foundation
+import Quick
+import Nimble
+import ReactiveTask
+@testable import CarthageKit
+
+class ToolchainCacheSpec: QuickSpec {
+	override func spec() {
+		let path = (NSTemporaryDirectory() as NSString).appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString)
+		let temporaryURL = URL(fileURLWithPath: path, isDirectory: true)
+		let developerDirectoryURL = temporaryURL.appendingPathComponent("Xcode.app/Contents/Developer", isDirectory: true)
+		let cacheDirectoryURL = temporaryURL.appendingPathComponent("Toolchains", isDirectory: true)
+		let xcodebuildURL = developerDirectoryURL.appendingPathComponent("usr/bin/xcodebuild", isDirectory: false)
+
+		beforeEach {
+			expect { try FileManager.default.createDirectory(at: xcodebuildURL.deletingLastPathComponent(), withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try Data("xcodebuild".utf8).write(to: xcodebuildURL) }.notTo(throwError())
+		}
+
+		afterEach {
+			_ = try? FileManager.default.removeItem(at: temporaryURL)
+		}
+
+		it("should fingerprint toolchains by their files") {
+			let fingerprint = ToolchainCache.fingerprint(developerDirectoryURL: developerDirectoryURL, toolchain: nil)
+			expect(fingerprint).notTo(beNil())
+			expect(ToolchainCache.fingerprint(developerDirectoryURL: developerDirectoryURL, toolchain: "org.swift.50320201215a")) != fingerprint
+
+			// Updating Xcode replaces its files.
+			expect { try Data("updated xcodebuild".utf8).write(to: xcodebuildURL, options: .atomic) }.notTo(throwError())
+			expect(ToolchainCache.fingerprint(developerDirectoryURL: developerDirectoryURL, toolchain: nil)) != fingerprint
+		}
+
+		it("should not fingerprint directories without Xcode") {
+			expect(ToolchainCache.fingerprint(developerDirectoryURL: temporaryURL, toolchain: nil)).to(beNil())
+		}
+
+		it("should only launch tasks whose output isn't cached") {
+			let task = Task("/bin/echo", arguments: [ "Xcode 12.4" ])
+			func output() -> String? {
+				return ToolchainCache.output(of: task, developerDirectoryURL: developerDirectoryURL, directoryURL: cacheDirectoryURL)
+					.single()?
+					.value
+					.flatMap { String(data: $0, encoding: .utf8) }
+			}
+
+			expect(output()) == "Xcode 12.4\n"
+
+			let cachedFileURLs = try? FileManager.default.contentsOfDirectory(at: cacheDirectoryURL, includingPropertiesForKeys: nil)
+			expect(cachedFileURLs?.count) == 1
+			expect { try Data("Xcode 12.5\n".utf8).write(to: cachedFileURLs![0]) }.notTo(throwError())
+
+			expect(output()) == "Xcode 12.5\n"
+		}
+	}
+}
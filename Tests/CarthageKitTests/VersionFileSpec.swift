@@ -126,6 +126,57 @@ class VersionFileSpec: QuickSpec {
 			expect(iosFramework["swiftToolchainVersion"]) == "4.2 (swiftlang-1000.11.37.1 clang-1000.11.45.1)"
 		}
 
+		it("should not match when the recorded build inputs differ") {
+			let directoryURL = URL(fileURLWithPath: NSTemporaryDirectory(), isDirectory: true)
+				.appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString, isDirectory: true)
+			defer { _ = try? FileManager.default.removeItem(at: directoryURL) }
+
+			let dependency = Dependency.gitHub(.dotCom, Repository(owner: "owner", name: "TestFramework"))
+			let versionFile = VersionFile(commitish: "v1.0", macOS: nil, iOS: [], watchOS: nil, tvOS: nil)
+				.recordingBuildInputs("inputs")
+			expect(versionFile.write(to: VersionFile.url(for: dependency, rootDirectoryURL: directoryURL)).error).to(beNil())
+
+			let matches = versionFileMatches(
+				dependency,
+				version: PinnedVersion("v1.0"),
+				platforms: [ .iOS ],
+				rootDirectoryURL: directoryURL,
+				toolchain: nil,
+				buildInputs: "other inputs"
+			)
+			expect(matches.single()?.value ?? nil) == false
+		}
+
+		it("should fingerprint the products independently of the revision they were built from") {
+			let binariesDirectoryURL = URL(fileURLWithPath: NSTemporaryDirectory(), isDirectory: true)
+				.appendingPathComponent(ProcessInfo.processInfo.globallyUniqueString, isDirectory: true)
+			defer { _ = try? FileManager.default.removeItem(at: binariesDirectoryURL) }
+
+			let headersURL = binariesDirectoryURL.appendingPathComponent("iOS/TestFramework.framework/Headers", isDirectory: true)
+			let headerURL = headersURL.appendingPathComponent("TestFramework.h", isDirectory: false)
+			expect { try FileManager.default.createDirectory(at: headersURL, withIntermediateDirectories: true) }.notTo(throwError())
+			expect { try "int test(void);".write(to: headerURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+
+			func versionFile(commitish: String, hash: String) -> VersionFile {
+				let cachedFramework = CachedFramework(
+					name: "TestFramework",
+					container: nil,
+					libraryIdentifier: nil,
+					hash: hash,
+					linking: .dynamic,
+					swiftToolchainVersion: nil
+				)
+				return VersionFile(commitish: commitish, macOS: nil, iOS: [ cachedFramework ], watchOS: nil, tvOS: nil)
+			}
+
+			let fingerprint = versionFile(commitish: "v1.0", hash: "TestHASH").productFingerprint(binariesDirectoryURL: binariesDirectoryURL)
+			expect(versionFile(commitish: "v1.1", hash: "TestHASH").productFingerprint(binariesDirectoryURL: binariesDirectoryURL)) == fingerprint
+			expect(versionFile(commitish: "v1.1", hash: "OtherHASH").productFingerprint(binariesDirectoryURL: binariesDirectoryURL)) != fingerprint
+
+			expect { try "int test(int);".write(to: headerURL, atomically: true, encoding: .utf8) }.notTo(throwError())
+			expect(versionFile(commitish: "v1.0", hash: "TestHASH").productFingerprint(binariesDirectoryURL: binariesDirectoryURL)) != fingerprint
+		}
+
 		func validate(file: VersionFile, matches: Bool, platform: String, commitish: String, hashes: [String?],
 		              swiftVersionMatches: [Bool], fileName: FileString = #file, line: UInt = #line) {
 			_ = file.satisfies(platform: SDK(rawValue: platform)!, commitish: commitish, hashes: hashes, swiftVersionMatches: swiftVersionMatches)
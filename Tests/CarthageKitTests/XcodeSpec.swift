@@ -127,6 +127,24 @@ class XcodeSpec: QuickSpec {
 			}
 		}
 
+		describe("buildableReferenceKeys") {
+			it("should describe the targets and products of a scheme's build action") {
+				let keys = buildableReferenceKeys(of: Scheme("ReactiveCocoaLayout Mac"), inProjectAt: projectURL)
+				let projectPath = projectURL.standardizedFileURL.path
+
+				expect(keys) == [
+					"reference:\(projectPath):D0BB24881678772C005E9371",
+					"product:ReactiveCocoaLayout Mac Tests.xctest",
+					"reference:\(projectPath):D0BB24701678772C005E9371",
+					"product:ReactiveCocoaLayout.framework",
+				]
+			}
+
+			it("should not describe a scheme which isn't shared") {
+				expect(buildableReferenceKeys(of: Scheme("Missing"), inProjectAt: projectURL)).to(beNil())
+			}
+		}
+
 		describe("locateProjectsInDirectory:") {
 			func relativePathsForProjectsInDirectory(_ directoryURL: URL) -> [String] {
 				let result = ProjectLocator
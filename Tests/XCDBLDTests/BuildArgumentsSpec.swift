@@ -89,6 +89,14 @@ class BuildArgumentsSpec: QuickSpec {
 				subject.destination = "exampleDestination"
 			}
 
+			itCreatesBuildArguments("includes the number of jobs if given", arguments: ["-jobs", "4"]) { subject in
+				subject.jobs = 4
+			}
+
+			itCreatesBuildArguments("includes the module cache if given", arguments: ["MODULE_CACHE_DIR=/tmp/ModuleCache"]) { subject in
+				subject.moduleCachePath = "/tmp/ModuleCache"
+			}
+
 			describe("specifying onlyActiveArchitecture") {
 				itCreatesBuildArguments("includes ONLY_ACTIVE_ARCH=YES if it's set to true", arguments: ["ONLY_ACTIVE_ARCH=YES"]) { subject in
 					subject.onlyActiveArchitecture = true